@@ -1720,8 +1720,8 @@ sint32 way_builder_t::intern_calc_route(const vector_tpl<koord3d> &start, const
 	static binary_heap_tpl <route_t::ANode *> queue;
 
 	// get exclusively a tile list
-	route_t::ANode *nodes;
-	uint8 ni = route_t::GET_NODES(&nodes);
+	route_t::node_pool_t *nodes;
+	const uint32 ni = route_t::GET_NODES(&nodes);
 
 	// initialize marker field
 	marker_t& marker = marker_t::instance(welt->get_size().x, welt->get_size().y, karte_t::marker_index);
@@ -1745,7 +1745,7 @@ sint32 way_builder_t::intern_calc_route(const vector_tpl<koord3d> &start, const
 			// DBG_MESSAGE("way_builder_t::intern_calc_route()","cannot start on (%i,%i,%i)",start.x,start.y,start.z);
 			continue;
 		}
-		tmp = &(nodes[step]);
+		tmp = nodes->alloc();
 		step ++;
 		if (route_t::max_used_steps < step)
 			route_t::max_used_steps = step;
@@ -1934,7 +1934,7 @@ DBG_DEBUG("insert to close","(%i,%i,%i)  f=%i",gr->get_pos().x,gr->get_pos().y,g
 			}
 
 			// not in there or taken out => add new
-			route_t::ANode *k=&(nodes[step]);
+			route_t::ANode *k=nodes->alloc();
 			step++;
 			if (route_t::max_used_steps < step)
 				route_t::max_used_steps = step;
@@ -2879,9 +2879,9 @@ const way_desc_t* grund_t::get_default_road(weg_t* w) const
 		bool city_destinations = false;
 		for (uint8 i = 0; i < 5; i++)
 		{
-			for (uint32 j = 0; j < w->private_car_routes[w->private_car_routes_currently_reading_element][i].get_count(); j++)
+			for (uint32 j = 0; j < w->get_private_car_routes(w->private_car_routes_currently_reading_element)[i].get_count(); j++)
 			{
-				const koord dest = w->private_car_routes[w->private_car_routes_currently_reading_element][i][j];
+				const koord dest = w->get_private_car_routes(w->private_car_routes_currently_reading_element)[i][j];
 
 				const stadt_t* city = welt->get_city(dest);
 				if (city && dest == city->get_townhall_road())
@@ -470,11 +470,7 @@ void weg_t::init()
 	//int error = pthread_rwlock_init(&private_car_store_route_rwlock, &rwlock_attributes);
 	//assert(error == 0);
 #endif
-	for(uint32 j=0; j<2; j++){
-		for(uint32 i=0; i<5; i++){
-			private_car_routes[j][i].set_route_map_elem(j);
-		}
-	}
+	private_car_routes.store(NULL);
 }
 
 
@@ -502,7 +498,7 @@ weg_t::~weg_t()
 			player_t::add_way_length( player, is_diagonal() ? -7 : -10, desc->get_finance_waytype());
 		}
 	}
-
+	delete private_car_routes.load();
 }
 
 
@@ -652,8 +648,11 @@ void weg_t::rdwr(loadsave_t *file)
 			{
 				for (uint32 i = 0; i < route_array_number; i++)
 				{
+					// ways without routes save empty maps
+					private_car_route_maps_t *routes = get_private_car_route_maps();
+					private_car_route_map *maps = routes ? routes->maps[i] : no_private_car_routes;
 					for(uint32 j=0; j<5; j++) {
-						private_car_routes[i][j].rdwr(file);
+						maps[j].rdwr(file);
 					}
 				}
 			}
@@ -661,6 +660,7 @@ void weg_t::rdwr(loadsave_t *file)
 			{
 				for (uint32 i = 0; i < route_array_number; i++)
 				{
+					private_car_route_map *maps = access_private_car_routes(i);
 					// Unfortunately, the way private car routes are stored has changed a number of times in an effort to save memory.
 					if((file->get_extended_version()==14 && file->get_extended_revision() >= 19) || file->get_extended_version() > 14) {
 						if(file->get_extended_version() == 14 && file->get_extended_revision() < 37) {
@@ -673,27 +673,44 @@ void weg_t::rdwr(loadsave_t *file)
 									// Koord3d representation
 									koord3d next_tile;
 									next_tile.rdwr(file);
-									private_car_routes[i][get_map_idx(next_tile)].insert_unique(destination);
+									maps[get_map_idx(next_tile)].insert_unique(destination);
 								} else {
 									// Integer-neighbour representation
 									uint8 next_tile_neighbour;
 									file->rdwr_byte(next_tile_neighbour);
-									private_car_routes[i][get_map_idx(private_car_t::neighbour_from_int(get_pos(), next_tile_neighbour))].insert_unique(destination);
+									maps[get_map_idx(private_car_t::neighbour_from_int(get_pos(), next_tile_neighbour))].insert_unique(destination);
 								}
 							}
 						} else {
 							// Container membership representation
 							for(uint8 j=0; j<5; j++) {
-								private_car_routes[i][j].rdwr(file);
+								maps[j].rdwr(file);
 							}
 
 							if(file->is_version_ex_less(14,39)) {
 								// Correct for nsew->nesw change
-								std::swap(private_car_routes[i][1],private_car_routes[i][2]);
+								std::swap(maps[1],maps[2]);
 							}
 						}
 					}
 				}
+
+				// do not keep empty maps around
+				bool has_routes = false;
+				for (uint32 i = 0; i < 2 && !has_routes; i++)
+				{
+					for(uint8 j=0; j<5; j++) {
+						if(!get_private_car_route_maps()->maps[i][j].is_empty()) {
+							has_routes = true;
+							break;
+						}
+					}
+				}
+				if (!has_routes)
+				{
+					delete private_car_routes.load();
+					private_car_routes.store(NULL);
+				}
 			}
 		}
 	}
@@ -1775,6 +1792,37 @@ void weg_t::private_car_route_map::reset(uint8 map_elem){
 	route_maps[map_elem].resize(0);
 }
 
+weg_t::private_car_route_map weg_t::no_private_car_routes[5];
+
+weg_t::private_car_route_maps_t::private_car_route_maps_t()
+{
+	for(uint32 j=0; j<2; j++){
+		for(uint32 i=0; i<5; i++){
+			maps[j][i].set_route_map_elem(j);
+		}
+	}
+}
+
+weg_t::private_car_route_map *weg_t::access_private_car_routes(uint32 elem)
+{
+	private_car_route_maps_t *routes = private_car_routes.load(std::memory_order_relaxed);
+	if(routes==NULL){
+		routes = new private_car_route_maps_t();
+		// readers on other threads must see the maps constructed before the pointer
+		private_car_routes.store(routes, std::memory_order_release);
+	}
+	return routes->maps[elem];
+}
+
+void weg_t::clear_private_car_routes(uint32 elem)
+{
+	if(private_car_route_maps_t *routes = get_private_car_route_maps()){
+		for(auto & l : routes->maps[elem]) {
+			l.pre_reset();
+		}
+	}
+}
+
 weg_t::private_car_route_map* weg_t::private_car_backtrace_last_route_map=NULL;
 uint8 weg_t::private_car_backtrace_last_idx=0;
 
@@ -1789,7 +1837,7 @@ void weg_t::private_car_backtrace_end(){
 
 void weg_t::private_car_backtrace_add(koord destination, koord3d next_tile){
 	uint8 writing_elem=get_private_car_routes_currently_writing_element();
-	auto map = private_car_routes[writing_elem];
+	auto map = access_private_car_routes(writing_elem);
 	const uint8 map_idx = get_map_idx(next_tile);
 
 	if(!map[map_idx].contains(destination)) {
@@ -1808,7 +1856,7 @@ void weg_t::private_car_backtrace_add(koord destination, koord3d next_tile){
 
 void weg_t::private_car_backtrace_inc(koord3d next_tile){
 	uint8 writing_elem=get_private_car_routes_currently_writing_element();
-	auto map = private_car_routes[writing_elem];
+	auto map = access_private_car_routes(writing_elem);
 	const uint8 map_idx = get_map_idx(next_tile);
 	private_car_backtrace_last_route_map=map+map_idx;
 	private_car_backtrace_last_idx=map_idx;
@@ -1819,7 +1867,7 @@ void weg_t::add_private_car_route(koord destination, koord3d next_tile)
 
 	uint8 writing_elem=get_private_car_routes_currently_writing_element();
 	private_car_route_map::route_map_lock();
-	auto map = private_car_routes[writing_elem];
+	auto map = access_private_car_routes(writing_elem);
 	const uint8 map_idx = get_map_idx(next_tile);
 
 	if(!map[map_idx].contains(destination)) {
@@ -1858,7 +1906,7 @@ void weg_t::delete_all_routes_from_here(bool reading_set)
 	vector_tpl<koord> destinations_to_delete;
 
 	for(uint8 i=0;i<5;i++) {
-		auto &map = private_car_routes[routes_index][i];
+		auto &map = get_private_car_routes(routes_index)[i];
 		if (!map.is_empty()) {
 			for(uint32 j=0; j<map.get_count();j++) {
 				destinations_to_delete.append(map[j]);
@@ -1909,9 +1957,11 @@ void weg_t::remove_private_car_route(koord destination, bool reading_set)
 {
 	const uint32 routes_index = reading_set ? private_car_routes_currently_reading_element : get_private_car_routes_currently_writing_element();
 	private_car_route_map::route_map_lock();
-	for(uint8 i=0;i<5;i++) {
-		if(private_car_routes[routes_index][i].remove(destination)) {
-			break;
+	if(private_car_route_maps_t *routes = get_private_car_route_maps()) {
+		for(uint8 i=0;i<5;i++) {
+			if(routes->maps[routes_index][i].remove(destination)) {
+				break;
+			}
 		}
 	}
 	private_car_route_map::route_map_unlock();
@@ -1946,7 +1996,12 @@ koord3d weg_t::get_next_on_private_car_route_to(koord dest, bool reading_set, ui
 #ifdef NO_PRIVATE_CAR_DESTINATION_LINKING
 	startdir=0;
 #endif
-	auto map = private_car_routes[reading_set ? private_car_routes_currently_reading_element : get_private_car_routes_currently_writing_element()];
+	const private_car_route_maps_t *routes = get_private_car_route_maps();
+	if(routes==NULL){
+		// no route passes here
+		return koord3d();
+	}
+	auto map = routes->maps[reading_set ? private_car_routes_currently_reading_element : get_private_car_routes_currently_writing_element()];
 	if(map[4].contains(dest)){
 		return koord3d::invalid;
 	}
@@ -12,6 +12,8 @@
 #include <unordered_map>
 #endif
 
+#include <atomic>
+
 #include "../../display/simimg.h"
 #include "../../simtypes.h"
 #include "../../obj/simobj.h"
@@ -326,12 +328,41 @@ public:
 
 
 
-	// Likewise, out of caution, put this here for the same reason.
-	// n_bags must be fairly low as there are 2 maps per way and usually zero elements per way, up to ~150 in high cases and ~1500 in highest cases
-	//typedef ordered_vector_tpl<koord, uint32> private_car_route_map;
-	//typedef std::unordered_map<koord, koord3d> private_car_route_map_2;
-	private_car_route_map private_car_routes[2][5];
-	//private_car_route_map_2 private_car_routes_std[2];
+private:
+	/**
+	 * Both route sets of this way, each with one map per direction (nesw)
+	 * and one for routes ending here. Most ways are never on a private car route,
+	 * so this is only allocated once a route has been recorded on this way.
+	 * The route threads allocate it while others read it, hence it is published
+	 * with release and read with acquire semantics.
+	 */
+	struct private_car_route_maps_t {
+		private_car_route_map maps[2][5];
+		private_car_route_maps_t();
+	};
+	std::atomic<private_car_route_maps_t *> private_car_routes;
+
+	/// the route maps or NULL, safe to call from any thread
+	private_car_route_maps_t *get_private_car_route_maps() const { return private_car_routes.load(std::memory_order_acquire); }
+
+	/// stands in for the maps of ways without any routes
+	static private_car_route_map no_private_car_routes[5];
+
+	/// The five maps of route set elem, allocated if needed.
+	/// Call only with route_map_lock() held or from single threaded code.
+	private_car_route_map *access_private_car_routes(uint32 elem);
+
+public:
+	/// The five maps of route set elem (all empty if no route was recorded here)
+	const private_car_route_map *get_private_car_routes(uint32 elem) const
+	{
+		const private_car_route_maps_t *routes = get_private_car_route_maps();
+		return routes ? routes->maps[elem] : no_private_car_routes;
+	}
+
+	/// Empties route set elem of this way. Call only with route_map_lock() held.
+	void clear_private_car_routes(uint32 elem);
+
 	static uint32 private_car_routes_currently_reading_element;
 	static uint32 get_private_car_routes_currently_writing_element() { return private_car_routes_currently_reading_element == 1 ? 0 : 1; }
 
@@ -36,6 +36,7 @@ target_sources(simutrans-extended PRIVATE
 	dataobj/loadsave.cc
 	dataobj/marker.cc
 	dataobj/objlist.cc
+	dataobj/pak_cache.cc
 	dataobj/powernet.cc
 	dataobj/rect.cc
 	dataobj/replace_data.cc
@@ -239,6 +240,7 @@ target_sources(simutrans-extended PRIVATE
 	io/rdwr/adler32_stream.cc
 	io/rdwr/bzip2_file_rdwr_stream.cc
 	io/rdwr/compare_file_rd_stream.cc
+	io/rdwr/memory_rdwr_stream.cc
 	io/rdwr/raw_file_rdwr_stream.cc
 	io/rdwr/rdwr_stream.cc
 	io/rdwr/zlib_file_rdwr_stream.cc
@@ -369,6 +371,7 @@ target_sources(simutrans-extended PRIVATE
 	utils/simrandom.cc
 	utils/simstring.cc
 	utils/simthread.cc
+	utils/step_profiler.cc
 	vehicle/movingobj.cc
 	vehicle/pedestrian.cc
 	vehicle/simroadtraffic.cc
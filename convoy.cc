@@ -187,12 +187,39 @@ void weight_summary_t::add_vehicle(const vehicle_t &v)
 
 /******************************************************************************/
 
+void convoy_t::validate_physics_cache(const weight_summary_t &weight)
+{
+	physics_cache_t &c = physics_cache;
+	const float32e8_t F = get_braking_force();
+	if(  c.valid  &&  c.weight == weight.weight  &&  c.weight_cos == weight.weight_cos  &&  c.weight_sin == weight.weight_sin  &&
+		c.cf == adverse.cf  &&  c.fr == adverse.fr  &&  c.braking_force == F  ) {
+		return;
+	}
+	c.weight = weight.weight;
+	c.weight_cos = weight.weight_cos;
+	c.weight_sin = weight.weight_sin;
+	c.cf = adverse.cf;
+	c.fr = adverse.fr;
+	c.braking_force = F;
+	c.steps_per_meter = float32e8_t::zero;
+	c.max_speed = -1;
+	for(  int i = 0;  i < BRAKING_CACHE_SIZE;  i++  ) {
+		c.brake_speed[i] = -1;
+	}
+	c.valid = true;
+}
+
 sint32 convoy_t::calc_max_speed(const weight_summary_t &weight)
 {
 	const float32e8_t Frs = g_accel * (get_adverse_summary().fr * weight.weight_cos + weight.weight_sin);
+	validate_physics_cache(weight);
+	if(  physics_cache.max_speed >= 0  ) {
+		return physics_cache.max_speed;
+	}
 	if (Frs > get_starting_force())
 	{
 		// this convoy is too heavy to start.
+		physics_cache.max_speed = 0;
 		return 0;
 	}
 
@@ -237,7 +264,8 @@ sint32 convoy_t::calc_max_speed(const weight_summary_t &weight)
 	const float32e8_t q2 = get_continuous_power() / (float32e8_t::two * adverse.cf);
 	const float32e8_t sd = signed_power(q2 * q2 + p3 * p3 * p3, float32e8_t::half);
 	const float32e8_t vmax = signed_power(q2 + sd, float32e8_t::third) + signed_power(q2 - sd, float32e8_t::third);
-	return min(vehicle_summary.max_speed, (sint32)(vmax * ms2kmh + float32e8_t::one)); // 1.0 to compensate inaccuracy of calculation and make sure this is at least what calc_move() evaluates.
+	physics_cache.max_speed = min(vehicle_summary.max_speed, (sint32)(vmax * ms2kmh + float32e8_t::one)); // 1.0 to compensate inaccuracy of calculation and make sure this is at least what calc_move() evaluates.
+	return physics_cache.max_speed;
 }
 
 sint32 convoy_t::calc_max_weight(sint32 sin_alpha)
@@ -288,8 +316,27 @@ float32e8_t convoy_t::calc_min_braking_distance(const weight_summary_t &weight,
 
 sint32 convoy_t::calc_min_braking_distance(const settings_t &settings, const weight_summary_t &weight, sint32 speed)
 {
-	const float32e8_t x = calc_min_braking_distance(weight, speed_to_v(speed)) * _110_percent;
-	return settings.meters_to_steps(x).to_sint32();
+	if(  speed < 0  ) {
+		const float32e8_t x = calc_min_braking_distance(weight, speed_to_v(speed)) * _110_percent;
+		return settings.meters_to_steps(x).to_sint32();
+	}
+
+	physics_cache_t &c = physics_cache;
+	validate_physics_cache(weight);
+	if(  c.steps_per_meter != settings.get_steps_per_meter()  ) {
+		c.steps_per_meter = settings.get_steps_per_meter();
+		for(  int i = 0;  i < BRAKING_CACHE_SIZE;  i++  ) {
+			c.brake_speed[i] = -1;
+		}
+	}
+	// speed limits are mostly multiples of some km/h, so spread them by a hash
+	const uint32 i = (((uint32)speed * 2654435761u) >> 16) % BRAKING_CACHE_SIZE;
+	if(  c.brake_speed[i] != speed  ) {
+		const float32e8_t x = calc_min_braking_distance(weight, speed_to_v(speed)) * _110_percent;
+		c.brake_speed[i] = speed;
+		c.brake_steps[i] = settings.meters_to_steps(x).to_sint32();
+	}
+	return c.brake_steps[i];
 }
 
 
@@ -356,6 +403,28 @@ void convoy_t::calc_move(const settings_t &settings, long delta_t, const weight_
 		float32e8_t dx = float32e8_t::zero; // covered distance in m
 		float32e8_t v = akt_v; // v and akt_v in m/s
 		float32e8_t bf = float32e8_t::zero; // braking force in N
+
+		// cruising with the same inputs as before?
+		const float32e8_t fr = get_adverse_summary().fr;
+		const sint32 force_factor = settings.get_global_force_factor_percent();
+		for (int i = 0; i < 2; i++)
+		{
+			const move_cache_t &c = move_cache[i];
+			if (c.valid && c.dx_max < xbrk && c.v == v && c.delta_s == delta_s && c.vsoll == vsoll && c.weight == weight.weight &&
+				c.weight_cos == weight.weight_cos && c.weight_sin == weight.weight_sin && c.cf == adverse.cf && c.fr == fr && c.force_factor == force_factor)
+			{
+				dx = c.dx;
+				v = c.v_end;
+				delta_s = float32e8_t::zero; // skip the integration
+				break;
+			}
+		}
+		const float32e8_t delta_s_start = delta_s;
+		const float32e8_t v_start = v;
+		const float32e8_t vsoll_start = vsoll;
+		bool cacheable = delta_s > float32e8_t::zero;
+		float32e8_t dx_max = float32e8_t::zero; // largest distance reached
+
 		// iterate the passed time.
 		while (delta_s > float32e8_t::zero)
 		{
@@ -366,6 +435,11 @@ void convoy_t::calc_move(const settings_t &settings, long delta_t, const weight_
 				vsoll = vlim;
 				is_braking = true;
 			}
+			if (is_braking)
+			{
+				// depends on xbrk and xlim
+				cacheable = false;
+			}
 
 			float32e8_t f;
 			if (is_braking)
@@ -466,6 +540,7 @@ void convoy_t::calc_move(const settings_t &settings, long delta_t, const weight_
 				if (x > xbrk)
 				{
 					// don't run beyond xbrk, where we must start braking.
+					cacheable = false;
 					x = xbrk;
 					if (xbrk > dx && abs(a) > float32e8_t::milli)
 					{
@@ -475,6 +550,9 @@ void convoy_t::calc_move(const settings_t &settings, long delta_t, const weight_
 				}
 			}
 			dx = x;
+			if (dx_max < dx) {
+				dx_max = dx;
+			}
 			if (delta_s == dt_s) {
 				// Fix strange bug (macOS, clang LLVM v9.0.0): when compiled without -fno-inline (DEBUG <= 1),
 				// and when delta_s == dt_s, delta_s - dt_s equals some positive number instead of zero, which
@@ -484,6 +562,25 @@ void convoy_t::calc_move(const settings_t &settings, long delta_t, const weight_
 				delta_s -= dt_s; // another time slice passed
 			}
 		}
+		if (cacheable)
+		{
+			// reusable as long as no braking point is within dx_max
+			move_cache_t &c = move_cache[next_move_cache];
+			next_move_cache ^= 1;
+			c.valid = true;
+			c.delta_s = delta_s_start;
+			c.v = v_start;
+			c.vsoll = vsoll_start;
+			c.weight = weight.weight;
+			c.weight_cos = weight.weight_cos;
+			c.weight_sin = weight.weight_sin;
+			c.cf = adverse.cf;
+			c.fr = fr;
+			c.force_factor = force_factor;
+			c.dx = dx;
+			c.dx_max = dx_max;
+			c.v_end = v;
+		}
 		akt_v = v;
 		akt_speed = v_to_speed(v); // akt_speed in simutrans vehicle speed, v in m/s
 		sp_soll += (sint32)(settings.meters_to_steps(dx) * steps2yards); // sp_soll in simutrans yards, dx in m
@@ -101,6 +101,9 @@ extern const float32e8_t BR_MAGLEV;
 extern const float32e8_t BR_ROAD;
 extern const float32e8_t BR_DEFAULT;
 
+// number of braking distances remembered per convoy
+#define BRAKING_CACHE_SIZE (8)
+
 /******************************************************************************/
 
 struct vehicle_summary_t
@@ -211,6 +214,58 @@ struct weight_summary_t
 class convoy_t /*abstract */
 {
 private:
+	/**
+	 * Inputs and result of a calc_move(), which neither braked nor reached its
+	 * braking point. Then the result depends on nothing but these inputs and the
+	 * vehicles. A cruising convoy gets the same inputs again and again, so the
+	 * integration can be skipped.
+	 */
+	struct move_cache_t
+	{
+		float32e8_t delta_s;
+		float32e8_t v;     // speed before in m/s
+		float32e8_t vsoll;
+		sint32 weight;
+		float32e8_t weight_cos;
+		float32e8_t weight_sin;
+		float32e8_t cf;
+		float32e8_t fr;
+		sint32 force_factor;
+		float32e8_t dx;    // covered distance in m
+		float32e8_t dx_max; // farthest distance reached on the way
+		float32e8_t v_end; // speed after in m/s
+		bool valid;
+	};
+
+	// two, as rounding may let a cruising convoy alternate between two speeds
+	move_cache_t move_cache[2];
+	uint8 next_move_cache;
+
+	/**
+	 * Maximum speed and braking distances already calculated for a weight.
+	 * The weight changes only at stops and slopes, while the signal lookahead asks
+	 * for the braking distances of the same few speed limits on every step.
+	 */
+	struct physics_cache_t
+	{
+		sint32 weight;
+		float32e8_t weight_cos;
+		float32e8_t weight_sin;
+		float32e8_t cf;
+		float32e8_t fr;
+		float32e8_t braking_force;
+		float32e8_t steps_per_meter;
+		sint32 max_speed; // in km/h, -1 if not calculated yet
+		sint32 brake_speed[BRAKING_CACHE_SIZE]; // in simutrans speed, -1 if unused
+		sint32 brake_steps[BRAKING_CACHE_SIZE];
+		bool valid;
+	};
+
+	physics_cache_t physics_cache;
+
+	// clears physics_cache, if it was calculated for another weight or adverse summary
+	void validate_physics_cache(const weight_summary_t &weight);
+
 	/**
 	 * Get force in N according to current speed in m/s
 	 */
@@ -234,6 +289,13 @@ protected:
 	vehicle_summary_t vehicle_summary;
 	adverse_summary_t adverse;
 
+	// must be called whenever the vehicles change
+	inline void invalidate_move_cache()
+	{
+		move_cache[0].valid = move_cache[1].valid = false;
+		physics_cache.valid = false;
+	}
+
 	/**
 	 * get brake force in kN according to current speed in m/s
 	 */
@@ -360,6 +422,11 @@ public:
 	 * @param sp_soll the number of simutrans yards still to go and returns the new number of simutrans yards to go.
 	 */
 	void calc_move(const class settings_t &settings, long delta_t, const weight_summary_t &weight, sint32 akt_speed_soll, sint32 next_speed_limit, sint32 steps_til_limit, sint32 steps_til_brake, sint32 &akt_speed, sint32 &sp_soll, float32e8_t &akt_v);
+
+	convoy_t() : next_move_cache(0)
+	{
+		invalidate_move_cache();
+	}
 	virtual ~convoy_t(){}
 };
 
@@ -397,6 +464,7 @@ public:
 	inline void invalidate_vehicle_summary()
 	{
 		is_valid &= ~(cd_vehicle_summary|cd_adverse_summary|cd_weight_summary|cd_starting_force|cd_continuous_power|cd_braking_force);
+		invalidate_move_cache();
 	}
 
 	// vehicle_summary is valid if (is_valid & cd_vehicle_summary != 0)
@@ -147,6 +147,11 @@ void crossing_logic_t::add_to_crossing( const vehicle_base_t *v )
 // or of a city car; releases the crossing which may switch state
 void crossing_logic_t::release_crossing( const vehicle_base_t *v )
 {
+	if(  v->get_typ() == obj_t::pedestrian  ) {
+		// never added in add_to_crossing(), so nothing to release
+		// (also pedestrians are stepped on several threads)
+		return;
+	}
 	if(  v->get_waytype() == desc->get_waytype(0)  ) {
 		on_way1.remove(v);
 		if(  state == CROSSING_REQUEST_CLOSE  &&  on_way1.empty()  ) {
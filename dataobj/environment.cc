@@ -39,6 +39,7 @@ const char *env_t::savegame_version_str = SAVEGAME_VER_NR;
 const char *env_t::savegame_ex_version_str = EXTENDED_VER_NR;
 const char *env_t::savegame_ex_revision_str = EXTENDED_REVISION_NR;
 bool env_t::straight_way_without_control = false;
+bool env_t::pak_cache = true;
 bool env_t::networkmode = false;
 bool env_t::restore_UI = false;
 extern uint16 network_server_port;
@@ -369,6 +369,9 @@ public:
 	/// how many internal pixel per height step (default 16)
 	static sint8 pak_tile_height_step;
 
+	/// keep images calculated from the pakset in the user directory (see pak_cache_t)
+	static bool pak_cache;
+
 	/// new height for old slopes after conversion - 1=single height, 2=double height
 	/// Only use during loading of old games!
 	static sint8 pak_height_conversion_factor;
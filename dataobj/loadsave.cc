@@ -362,6 +362,32 @@ loadsave_t::file_status_t loadsave_t::rd_open(const char *filename_utf8)
 		header_size -= sz;
 	}
 
+	return rd_open_header();
+}
+
+
+loadsave_t::file_status_t loadsave_t::rd_open(memory_rdwr_stream_t::buffer_t &buffer)
+{
+	close();
+
+	assert(stream == NULL);
+	mode = binary;
+	stream = new memory_rdwr_stream_t(buffer, false);
+
+	// the header is read while classifying, so there is nothing to skip afterwards
+	finfo = file_info_t(file_info_t::TYPE_RAW);
+	if (stream->get_status() != rdwr_stream_t::STATUS_OK  ||  !classify_file_data(stream, &finfo)  ||  finfo.file_type != file_info_t::TYPE_RAW) {
+		close();
+		dbg->warning("loadsave_t::rd_open", "Cannot read savegame from memory");
+		return FILE_STATUS_ERR_NO_VERSION;
+	}
+
+	return rd_open_header();
+}
+
+
+loadsave_t::file_status_t loadsave_t::rd_open_header()
+{
 	if(*finfo.pak_extension==0) {
 		strcpy( finfo.pak_extension, "(unknown)" );
 	}
@@ -405,6 +431,26 @@ loadsave_t::file_status_t loadsave_t::wr_open( const char *filename_utf8, mode_t
 	mode = m;
 	close();
 
+	assert(stream == NULL);
+
+	stream = open_write_stream(filename_utf8, mode, level);
+	if (!stream) {
+		return FILE_STATUS_ERR_UNSUPPORTED_COMPRESSION;
+	}
+
+	if (stream->get_status() != rdwr_stream_t::STATUS_OK) {
+		dbg->error("loadsave_t::wr_open", "Cannot open '%s' for writing!", filename_utf8);
+		return (stream->get_status() == rdwr_stream_t::STATUS_ERR_NOT_EXISTING) ? FILE_STATUS_ERR_NOT_EXISTING : FILE_STATUS_ERR_CORRUPT;
+	}
+
+	set_buffered( true );
+
+	return wr_open_header(pak_extension, savegame_version, savegame_version_ex);
+}
+
+
+rdwr_stream_t *loadsave_t::open_write_stream(const char *filename_utf8, int &mode, int level)
+{
 #if !USE_ZSTD
 	if( mode & zstd ) {
 		mode &= ~zstd;
@@ -413,27 +459,66 @@ loadsave_t::file_status_t loadsave_t::wr_open( const char *filename_utf8, mode_t
 	}
 #endif
 
-	assert(stream == NULL);
-
 	switch (mode & ~xml) {
 #if USE_ZSTD
-		case zstd: stream = new zstd_file_rdwr_stream_t(filename_utf8, true, level); break;
+		case zstd:   return new zstd_file_rdwr_stream_t(filename_utf8, true, level);
 #endif
-		case bzip2:  stream = new bzip2_file_rdwr_stream_t(filename_utf8, true);       break;
-		case zipped: stream = new zlib_file_rdwr_stream_t(filename_utf8, true, level); break;
-		case binary: stream = new raw_file_rdwr_stream_t(filename_utf8, true);         break;
+		case bzip2:  return new bzip2_file_rdwr_stream_t(filename_utf8, true);
+		case zipped: return new zlib_file_rdwr_stream_t(filename_utf8, true, level);
+		case binary: return new raw_file_rdwr_stream_t(filename_utf8, true);
 		default:
 			dbg->error("loadsave_t::wr_open", "Unsupported save file compression");
-			return FILE_STATUS_ERR_UNSUPPORTED_COMPRESSION;
+			return NULL;
 	}
+}
 
-	if (stream->get_status() != rdwr_stream_t::STATUS_OK) {
-		dbg->error("loadsave_t::wr_open", "Cannot open '%s' for writing!", filename_utf8);
-		return (stream->get_status() == rdwr_stream_t::STATUS_ERR_NOT_EXISTING) ? FILE_STATUS_ERR_NOT_EXISTING : FILE_STATUS_ERR_CORRUPT;
+
+const char *loadsave_t::write_snapshot(const memory_rdwr_stream_t::buffer_t &snapshot, const char *filename_utf8, mode_t m, int level)
+{
+	// the header of a snapshot is the same as that of a compressed binary save,
+	// so the file is just the compressed snapshot
+	int file_mode = m;
+	if (file_mode & xml) {
+		return "Unsupported save file compression";
 	}
 
-	set_buffered( true );
+	rdwr_stream_t *file = open_write_stream(filename_utf8, file_mode, level);
+	if (!file) {
+		return "Unsupported save file compression";
+	}
+
+	// write in pieces like the buffered saving, the compressors prefer that
+	size_t pos = 0;
+	while (file->get_status() == rdwr_stream_t::STATUS_OK  &&  pos < snapshot.len) {
+		const size_t len = snapshot.len - pos < LS_BUF_SIZE ? snapshot.len - pos : LS_BUF_SIZE;
+		file->write(snapshot.data + pos, len);
+		pos += len;
+	}
+
+	// the compressors may still hold back data
+	file->finish();
 
+	const char *errmsg = file->get_status() == rdwr_stream_t::STATUS_OK ? NULL : "Error during saving";
+	delete file;
+	return errmsg;
+}
+
+
+loadsave_t::file_status_t loadsave_t::wr_open(memory_rdwr_stream_t::buffer_t &buffer, const char *pak_extension, const char *savegame_version, const char *savegame_version_ex)
+{
+	close();
+
+	assert(stream == NULL);
+	mode = binary;
+	stream = new memory_rdwr_stream_t(buffer, true);
+
+	// not buffered: writing to memory is as fast as copying into the buffers
+	return wr_open_header(pak_extension, savegame_version, savegame_version_ex);
+}
+
+
+loadsave_t::file_status_t loadsave_t::wr_open_header(const char *pak_extension, const char *savegame_version, const char *savegame_version_ex)
+{
 	// get the right extension
 	const char *start = pak_extension;
 	const char *end = pak_extension + strlen(pak_extension)-1;
@@ -513,6 +598,9 @@ const char *loadsave_t::close()
 		set_buffered(false);
 	}
 
+	// write what the stream still holds back, so that its status covers all of the file
+	stream->finish();
+
 	const char *errmsg = NULL;
 
 	switch (stream->get_status()) {
@@ -13,6 +13,7 @@
 #include "../simtypes.h"
 #include "../io/classify_file.h"
 #include "../io/rdwr/rdwr_stream.h"
+#include "../io/rdwr/memory_rdwr_stream.h"
 
 
 class plainstring;
@@ -101,6 +102,16 @@ protected:
 
 	bool is_xml() const { return mode&xml; }
 
+	/// Reads the rest of the header, after the version has been classified and the stream is opened.
+	file_status_t rd_open_header();
+
+	/// Creates the stream for writing a file in @p mode, which is changed if a compression is not available.
+	/// @returns NULL for unsupported modes.
+	static rdwr_stream_t *open_write_stream(const char *filename_utf8, int &mode, int level);
+
+	/// Writes the header, after the stream is opened.
+	file_status_t wr_open_header(const char *pak_extension, const char *savegame_version, const char *savegame_version_ex);
+
 public:
 	static mode_t save_mode;     ///< default to use for saving
 	static mode_t autosave_mode; ///< default to use for autosaves and network mode client temp saves
@@ -122,6 +133,27 @@ public:
 
 	file_status_t rd_open(const char *filename);
 	file_status_t wr_open(const char *filename, mode_t mode, int level, const char *pak_extension, const char *savegame_version, const char *savegame_version_ex, const char *savegame_revision_ex);
+
+	/**
+	 * Open a savegame in memory, as written by the wr_open below.
+	 * @p buffer must stay unchanged until closing.
+	 */
+	file_status_t rd_open(memory_rdwr_stream_t::buffer_t &buffer);
+
+	/**
+	 * Save uncompressed into memory, for snapshots that are read back by the same program.
+	 * @p buffer is cleared first.
+	 */
+	file_status_t wr_open(memory_rdwr_stream_t::buffer_t &buffer, const char *pak_extension, const char *savegame_version, const char *savegame_version_ex);
+
+	/**
+	 * Writes a closed snapshot from the wr_open above into a file, as if the game had been saved there with @p mode.
+	 * Only the file and @p snapshot are accessed, so this can run on any thread.
+	 * XML modes are not supported.
+	 * @returns NULL on success, an error message otherwise.
+	 */
+	static const char *write_snapshot(const memory_rdwr_stream_t::buffer_t &snapshot, const char *filename_utf8, mode_t mode, int level);
+
 	const char *close();
 
 	static void set_savemode(mode_t mode) { save_mode = mode; }
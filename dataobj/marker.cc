@@ -7,6 +7,8 @@
 #include "../simtypes.h"
 #include "../simdebug.h"
 #include "../boden/grund.h"
+#include "../simplan.h"
+#include "../simworld.h"
 #include "marker.h"
 
 marker_t marker_t::the_instance;
@@ -16,17 +18,25 @@ void marker_t::init(int world_size_x, int world_size_y)
 {
 	// do not reallocate it, if same size ...
 	cached_size_x = world_size_x;
-	int new_bits_length = (world_size_x*world_size_y + bit_mask) / (bit_unit);
+	const uint32 new_bits_length = (world_size_x*world_size_y + bit_mask) / (bit_unit);
 
 	if( bits_length != new_bits_length  ) {
 		bits_length = new_bits_length;
 		delete [] bits;
+		delete [] bits_generation;
+		delete [] level_slots;
 		if(bits_length) {
-			bits = new unsigned char[bits_length];
+			bits = new uint64[bits_length];
+			bits_generation = new uint8[bits_length];
+			level_slots = new uint32[bits_length];
+			MEMZERON(bits_generation, bits_length);
 		}
 		else {
 			bits = NULL;
+			bits_generation = NULL;
+			level_slots = NULL;
 		}
+		generation = 0;
 	}
 	unmark_all();
 }
@@ -54,26 +64,60 @@ marker_t& marker_t::instance(int world_size_x, int world_size_y, uint32 thread_n
 marker_t::~marker_t()
 {
 	delete [] bits;
+	delete [] bits_generation;
+	delete [] level_slots;
 }
 
 void marker_t::unmark_all()
 {
-	if(bits) {
-		MEMZERON(bits, bits_length);
+	generation++;
+	if(  generation == 0  ) {
+		// wrapped around: words of generation 1 would appear marked again
+		if(bits_generation) {
+			MEMZERON(bits_generation, bits_length);
+		}
+		generation = 1;
+	}
+	levels_used = 0;
+}
+
+uint64 marker_t::get_level_bit(const grund_t *gr)
+{
+	const planquadrat_t *plan = world()->access(gr->get_pos().get_2d());
+	// ground 0 is the kartenboden, the others are sorted by height
+	// and there are far fewer heights than bits
+	uint32 i = 1;
+	while(  i < plan->get_boden_count()  &&  plan->get_boden_bei(i) != gr  ) {
+		i++;
 	}
-	more.clear();
+	return (uint64)1 << (i & bit_mask);
 }
 
 void marker_t::mark(const grund_t *gr)
 {
 	if(gr != NULL) {
+		const int bit = gr->get_pos().y*cached_size_x+gr->get_pos().x;
+		const uint32 word = current_word(bit);
 		if(gr->ist_karten_boden()) {
 			// ground level
-			const int bit = gr->get_pos().y*cached_size_x+gr->get_pos().x;
-			bits[bit/bit_unit] |= 1 << (bit & bit_mask);
+			bits[word] |= (uint64)1 << (bit & bit_mask);
 		}
 		else {
-			more.set(gr, true);
+			if(  level_slots[word] == no_level_slot  ) {
+				// first non-ground tile of this word in this generation
+				if(  (levels_used+1)*bit_unit > levels.get_count()  ) {
+					for(  uint32 i=0;  i<bit_unit;  i++  ) {
+						levels.append(0);
+					}
+				}
+				else {
+					for(  uint32 i=0;  i<bit_unit;  i++  ) {
+						levels[levels_used*bit_unit+i] = 0;
+					}
+				}
+				level_slots[word] = levels_used++;
+			}
+			levels[level_slots[word]*bit_unit + (bit & bit_mask)] |= get_level_bit(gr);
 		}
 	}
 }
@@ -81,13 +125,14 @@ void marker_t::mark(const grund_t *gr)
 void marker_t::unmark(const grund_t *gr)
 {
 	if(gr != NULL) {
+		const int bit = gr->get_pos().y*cached_size_x+gr->get_pos().x;
+		const uint32 word = current_word(bit);
 		if(gr->ist_karten_boden()) {
 			// ground level
-			const int bit = gr->get_pos().y*cached_size_x+gr->get_pos().x;
-			bits[bit/bit_unit] &= ~(1 << (bit & bit_mask));
+			bits[word] &= ~((uint64)1 << (bit & bit_mask));
 		}
-		else {
-			more.remove(gr);
+		else if(  level_slots[word] != no_level_slot  ) {
+			levels[level_slots[word]*bit_unit + (bit & bit_mask)] &= ~get_level_bit(gr);
 		}
 	}
 }
@@ -97,13 +142,17 @@ bool marker_t::is_marked(const grund_t *gr) const
 	if(gr==NULL) {
 		return false;
 	}
+	const int bit = gr->get_pos().y*cached_size_x+gr->get_pos().x;
+	const uint32 word = bit/bit_unit;
+	if(  bits_generation[word] != generation  ) {
+		return false;
+	}
 	if(gr->ist_karten_boden()) {
 		// ground level
-		const int bit = gr->get_pos().y*cached_size_x+gr->get_pos().x;
-		return (bits[bit/bit_unit] & (1 << (bit & bit_mask))) != 0;
+		return (bits[word] & ((uint64)1 << (bit & bit_mask))) != 0;
 	}
 	else {
-		return more.get(gr);
+		return level_slots[word] != no_level_slot  &&  (levels[level_slots[word]*bit_unit + (bit & bit_mask)] & get_level_bit(gr)) != 0;
 	}
 }
 
@@ -113,13 +162,18 @@ bool marker_t::test_and_mark(const grund_t *gr)
 		if(gr->ist_karten_boden()) {
 			// ground level
 			const int bit = gr->get_pos().y*cached_size_x+gr->get_pos().x;
-			if ((bits[bit/bit_unit] & (1 << (bit & bit_mask))) != 0) {
+			const uint32 word = current_word(bit);
+			const uint64 mask = (uint64)1 << (bit & bit_mask);
+			if ((bits[word] & mask) != 0) {
 				return true;
 			}
-			bits[bit/bit_unit] |= 1 << (bit & bit_mask);
+			bits[word] |= mask;
 		}
 		else {
-			return more.set(gr, true);
+			if(is_marked(gr)) {
+				return true;
+			}
+			mark(gr);
 		}
 	}
 	return false;
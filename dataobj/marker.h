@@ -7,7 +7,7 @@
 #define DATAOBJ_MARKER_H
 
 
-#include "../tpl/ptrhashtable_tpl.h"
+#include "../tpl/vector_tpl.h"
 
 #include "../utils/simthread.h"
 
@@ -16,26 +16,48 @@ class grund_t;
 /**
  * Class to mark tiles as visited during route search.
  * Singleton.
+ *
+ * Tiles are grouped into words of 64 tiles. Each word carries the generation
+ * (i.e. the search) it was last written in, so starting a new search only
+ * increments the generation instead of clearing the whole map.
  */
 class marker_t {
 	// added bit mask, because it allows a more efficient
 	// implementation (use & instead of %)
 	enum {
-		bit_unit = (8 * sizeof(unsigned char)),
-		bit_mask = (8 * sizeof(unsigned char))-1
+		bit_unit = (8 * sizeof(uint64)),
+		bit_mask = (8 * sizeof(uint64))-1
 	};
 
+	enum { no_level_slot = 0xFFFFFFFFu };
+
+	/// current generation, words of other generations count as unmarked
+	uint8 generation;
+
 	/// bit-field to mark ground tiles
-	unsigned char *bits;
+	uint64 *bits;
+
+	/// generation of each word in bits
+	uint8 *bits_generation;
+
+	/// for each word: slot in levels for its non-ground tiles, or no_level_slot
+	uint32 *level_slots;
 
 	/// length of field
-	int bits_length;
+	uint32 bits_length;
 
 	/// bit-field is made for this x-size
 	int cached_size_x;
 
-	/// hashtable to mark non-ground tiles (bridges, tunnels)
-	ptrhashtable_tpl <const grund_t *, bool, N_BAGS_LARGE> more;
+	/**
+	 * Marks of non-ground tiles (bridges, tunnels): bit i of an entry stands for
+	 * ground i of the planquadrat. One slot of bit_unit entries is handed out to
+	 * each word whose non-ground tiles are marked in the current generation.
+	 */
+	vector_tpl<uint64> levels;
+
+	/// slots of levels handed out in the current generation
+	uint32 levels_used;
 
 	/**
 	 * Initializes marker. Set all tiles to not marked.
@@ -44,6 +66,21 @@ class marker_t {
 	 */
 	void init(int world_size_x, int world_size_y);
 
+	/// word of tile bit, reset if it is still from an older generation
+	inline uint32 current_word(int bit)
+	{
+		const uint32 word = bit/bit_unit;
+		if(  bits_generation[word] != generation  ) {
+			bits_generation[word] = generation;
+			bits[word] = 0;
+			level_slots[word] = no_level_slot;
+		}
+		return word;
+	}
+
+	/// bit for gr in levels (ground index within its tile)
+	static uint64 get_level_bit(const grund_t *gr);
+
 	/// the instance (single threaded only)
 	static marker_t the_instance;
 
@@ -52,7 +89,7 @@ public:
 	/// For running multi-threadedly
 	static marker_t* markers;
 
-	marker_t() : bits(NULL) { bits_length = 0; init(0, 0); }
+	marker_t() : generation(0), bits(NULL), bits_generation(NULL), level_slots(NULL), bits_length(0), levels_used(0) { init(0, 0); }
 	~marker_t();
 
 	/**
@@ -0,0 +1,204 @@
+/*
+ * This file is part of the Simutrans-Extended project under the Artistic License.
+ * (see LICENSE.txt)
+ */
+
+#include "pak_cache.h"
+
+#include "environment.h"
+#include "../simdebug.h"
+#include "../sys/simsys.h"
+#include "../descriptor/image.h"
+
+#include <sys/stat.h>
+#include <string.h>
+#include <zlib.h>
+
+
+// increase whenever the file layout or the calculation of cached images changes
+#define PAK_CACHE_VERSION (1)
+
+uint32 pak_cache_t::fingerprint = 0;
+
+
+/*
+ * The files are only meant for this machine, hence everything is stored in the
+ * native byte order. An image is stored as header followed by its pixel data.
+ */
+struct pak_cache_header_t
+{
+	char magic[4];
+	uint32 version;
+	uint32 fingerprint;
+	uint32 key;
+	uint32 pixval_size;
+	uint32 id_count;
+	uint32 image_count;
+};
+
+struct pak_cache_image_t
+{
+	sint32 x, y, w, h;
+	uint32 len;
+	uint32 zoomable;
+};
+
+
+void pak_cache_t::add_file(const char *filename)
+{
+	struct stat sb;
+	if(  dr_stat(filename, &sb) != 0  ) {
+		return;
+	}
+	const sint64 size = sb.st_size;
+	const sint64 mtime = sb.st_mtime;
+	uLong crc = crc32(fingerprint, (const Bytef *)filename, strlen(filename));
+	crc = crc32(crc, (const Bytef *)&size, sizeof(size));
+	crc = crc32(crc, (const Bytef *)&mtime, sizeof(mtime));
+	fingerprint = (uint32)crc;
+}
+
+
+std::string pak_cache_t::get_filename(const char *name)
+{
+	// one file per pakset, so switching paksets does not throw the cache away
+	std::string pak = env_t::objfilename;
+	while(  !pak.empty()  &&  pak[pak.size()-1] == '/'  ) {
+		pak.erase(pak.size()-1);
+	}
+	for(  size_t i = 0;  i < pak.size();  i++  ) {
+		if(  pak[i] == '/'  ||  pak[i] == '\\'  ||  pak[i] == ':'  ) {
+			pak[i] = '_';
+		}
+	}
+	return std::string(env_t::user_dir) + "cache/" + pak + "-" + name + ".bin";
+}
+
+
+bool pak_cache_t::read_images(const char *name, uint32 key, vector_tpl<image_t *> &images, uint32 *ids, uint32 count)
+{
+	images.clear();
+	if(  !env_t::pak_cache  ||  fingerprint == 0  ) {
+		return false;
+	}
+
+	const std::string filename = get_filename(name);
+	FILE *fp = dr_fopen(filename.c_str(), "rb");
+	if(  fp == NULL  ) {
+		return false;
+	}
+
+	// read everything at once, most of it are the pixels anyway
+	fseek(fp, 0, SEEK_END);
+	const long file_size = ftell(fp);
+	fseek(fp, 0, SEEK_SET);
+	if(  file_size < (long)sizeof(pak_cache_header_t)  ) {
+		fclose(fp);
+		return false;
+	}
+	char *buf = new char[file_size];
+	const bool read_ok = fread(buf, file_size, 1, fp) == 1;
+	fclose(fp);
+
+	const char *p = buf;
+	const char *const end = buf + file_size;
+
+	pak_cache_header_t header;
+	memcpy(&header, p, sizeof(header));
+	p += sizeof(header);
+
+	if(  !read_ok  ||  memcmp(header.magic, "SXPC", 4) != 0  ||  header.version != PAK_CACHE_VERSION  ||
+		header.fingerprint != fingerprint  ||  header.key != key  ||  header.pixval_size != sizeof(PIXVAL)  ||
+		header.id_count != count  ||  (size_t)(end - p) < count * sizeof(uint32)  ) {
+		DBG_MESSAGE("pak_cache_t::read_images()", "%s is outdated", filename.c_str());
+		delete [] buf;
+		return false;
+	}
+	memcpy(ids, p, count * sizeof(uint32));
+	p += count * sizeof(uint32);
+
+	bool ok = header.image_count <= (size_t)(end - p) / sizeof(pak_cache_image_t);
+	images.resize(ok ? header.image_count : 0);
+	for(  uint32 i = 0;  ok  &&  i < header.image_count;  i++  ) {
+		pak_cache_image_t img;
+		if(  (size_t)(end - p) < sizeof(img)  ) {
+			ok = false;
+			break;
+		}
+		memcpy(&img, p, sizeof(img));
+		p += sizeof(img);
+		if(  (size_t)(end - p) < img.len * sizeof(PIXVAL)  ) {
+			ok = false;
+			break;
+		}
+
+		image_t *image = new image_t(img.len);
+		image->len = img.len;
+		image->x = img.x;
+		image->y = img.y;
+		image->w = img.w;
+		image->h = img.h;
+		image->zoomable = (uint8)img.zoomable;
+		image->imageid = IMG_EMPTY;
+		memcpy(image->data, p, img.len * sizeof(PIXVAL));
+		p += img.len * sizeof(PIXVAL);
+		images.append(image);
+	}
+	delete [] buf;
+
+	if(  !ok  ||  p != end  ) {
+		dbg->warning("pak_cache_t::read_images()", "%s is damaged, ignored", filename.c_str());
+		clear_ptr_vector(images);
+		return false;
+	}
+
+	DBG_MESSAGE("pak_cache_t::read_images()", "%u images from %s", images.get_count(), filename.c_str());
+	return true;
+}
+
+
+void pak_cache_t::write_images(const char *name, uint32 key, const vector_tpl<image_t *> &images, const uint32 *ids, uint32 count)
+{
+	if(  !env_t::pak_cache  ||  fingerprint == 0  ) {
+		return;
+	}
+
+	dr_mkdir((std::string(env_t::user_dir) + "cache").c_str());
+	const std::string filename = get_filename(name);
+	// write under another name first, so an aborted write leaves no damaged cache behind
+	const std::string tmpname = filename + "_";
+	FILE *fp = dr_fopen(tmpname.c_str(), "wb");
+	if(  fp == NULL  ) {
+		dbg->warning("pak_cache_t::write_images()", "cannot write %s", tmpname.c_str());
+		return;
+	}
+
+	pak_cache_header_t header;
+	memcpy(header.magic, "SXPC", 4);
+	header.version = PAK_CACHE_VERSION;
+	header.fingerprint = fingerprint;
+	header.key = key;
+	header.pixval_size = sizeof(PIXVAL);
+	header.id_count = count;
+	header.image_count = images.get_count();
+
+	bool ok = fwrite(&header, sizeof(header), 1, fp) == 1;
+	ok &= count == 0  ||  fwrite(ids, count * sizeof(uint32), 1, fp) == 1;
+	for(image_t const* const image : images) {
+		pak_cache_image_t img;
+		img.x = image->x;
+		img.y = image->y;
+		img.w = image->w;
+		img.h = image->h;
+		img.len = (uint32)image->len;
+		img.zoomable = image->zoomable;
+		ok &= fwrite(&img, sizeof(img), 1, fp) == 1;
+		ok &= image->len == 0  ||  fwrite(image->data, image->len * sizeof(PIXVAL), 1, fp) == 1;
+	}
+	ok &= fclose(fp) == 0;
+
+	if(  !ok  ||  dr_rename(tmpname.c_str(), filename.c_str()) != 0  ) {
+		dbg->warning("pak_cache_t::write_images()", "cannot write %s", filename.c_str());
+		dr_remove(tmpname.c_str());
+	}
+}
@@ -0,0 +1,54 @@
+/*
+ * This file is part of the Simutrans-Extended project under the Artistic License.
+ * (see LICENSE.txt)
+ */
+
+#ifndef DATAOBJ_PAK_CACHE_H
+#define DATAOBJ_PAK_CACHE_H
+
+
+#include "../simtypes.h"
+#include "../tpl/vector_tpl.h"
+
+#include <string>
+
+
+class image_t;
+
+
+/**
+ * Keeps images which are calculated from the pakset after loading (like the
+ * ground transitions) in the user directory, so they need not be calculated
+ * again on the next start with the same pakset.
+ *
+ * A cache file is only used, if the names, sizes and modification times of all
+ * pak files read since the start are the same as when it was written (similar to
+ * sve_cache_t for the savegames), and if the key given by the caller matches.
+ */
+class pak_cache_t
+{
+	/// hash of the names, sizes and times of all pak files read so far
+	static uint32 fingerprint;
+
+	static std::string get_filename(const char *name);
+
+public:
+	/// adds a pak file to the fingerprint, called for every file read
+	static void add_file(const char *filename);
+
+	static uint32 get_fingerprint() { return fingerprint; }
+
+	/**
+	 * Reads the images and ids stored under this name. The images are not
+	 * registered yet and belong to the caller.
+	 * @param key anything else the images depend on
+	 * @return false if there is no valid cache, then images is empty
+	 */
+	static bool read_images(const char *name, uint32 key, vector_tpl<image_t *> &images, uint32 *ids, uint32 count);
+
+	/// stores the images and ids under this name
+	static void write_images(const char *name, uint32 key, const vector_tpl<image_t *> &images, const uint32 *ids, uint32 count);
+};
+
+
+#endif
@@ -26,12 +26,6 @@
 #include "../obj/roadsign.h"
 #include "environment.h"
 
-// define USE_VALGRIND_MEMCHECK to make
-// valgrind aware of the memory pool for A* nodes
-#ifdef USE_VALGRIND_MEMCHECK
-#include <valgrind/memcheck.h>
-#endif
-
 // if defined, print some profiling informations into the file
 //#define DEBUG_ROUTES
 
@@ -342,26 +336,27 @@ route_t::route_result_t route_t::calc_ocean_route(karte_t* welt, const koord3d s
 	}
 }
 
-// node arrays
+// node pools
 thread_local uint32 route_t::MAX_STEP=0;
 thread_local uint32 route_t::max_used_steps=0;
-thread_local route_t::ANode *route_t::_nodes[MAX_NODES_ARRAY];
-thread_local bool route_t::_nodes_in_use[MAX_NODES_ARRAY]; // semaphores, since we only have few nodes arrays in memory
+thread_local vector_tpl<route_t::node_pool_t *> *route_t::_node_pools = NULL;
 
-void route_t::INIT_NODES(uint32 max_route_steps, const koord &world_size)
+route_t::node_pool_t::~node_pool_t()
 {
-	for (int i = 0; i < MAX_NODES_ARRAY; ++i)
-	{
-		_nodes[i] = NULL;
-		_nodes_in_use[i] = false;
+	for(ANode *block : blocks) {
+		delete [] block;
 	}
+}
 
+void route_t::INIT_NODES(uint32 max_route_steps, const koord &world_size)
+{
 	// may need very much memory => configurable
+	// but the pools only grow to the size the searches actually need
 	const uint32 max_world_step_size = world_size == koord::invalid ? max_route_steps :  world_size.x * world_size.y * 2;
 	MAX_STEP = min(max_route_steps, max_world_step_size);
-	for (int i = 0; i < MAX_NODES_ARRAY; ++i)
+	if (_node_pools == NULL)
 	{
-		_nodes[i] = new ANode[MAX_STEP + 4 + 2];
+		_node_pools = new vector_tpl<node_pool_t *>(2);
 	}
 }
 
@@ -370,32 +365,105 @@ void route_t::TERM_NODES(void *)
 	if (MAX_STEP)
 	{
 		MAX_STEP = 0;
-		for (int i = 0; i < MAX_NODES_ARRAY; ++i)
+		if (_node_pools)
 		{
-			delete [] _nodes[i];
-			_nodes[i] = NULL;
-			_nodes_in_use[i] = false;
+			clear_ptr_vector(*_node_pools);
+			delete _node_pools;
+			_node_pools = NULL;
 		}
 	}
 }
-uint8 route_t::GET_NODES(ANode **nodes)
+
+uint32 route_t::GET_NODES(node_pool_t **nodes)
 {
-	for (int i = 0; i < MAX_NODES_ARRAY; ++i)
-		if (!_nodes_in_use[i])
+	for (uint32 i = 0; i < _node_pools->get_count(); ++i)
+	{
+		node_pool_t *pool = (*_node_pools)[i];
+		if (!pool->in_use)
 		{
-			_nodes_in_use[i] = true;
-			*nodes = _nodes[i];
+			pool->in_use = true;
+			pool->rewind();
+			*nodes = pool;
 			return i;
 		}
-	dbg->fatal("GET_NODE","called while list in use");
-	return 0;
+	}
+	// all pools busy (nested search) => add another one
+	node_pool_t *pool = new node_pool_t();
+	pool->in_use = true;
+	_node_pools->append(pool);
+	*nodes = pool;
+	return _node_pools->get_count() - 1;
 }
 
-void route_t::RELEASE_NODES(uint8 nodes_index)
+void route_t::RELEASE_NODES(uint32 nodes_index)
 {
-	if (!_nodes_in_use[nodes_index])
+	if (!(*_node_pools)[nodes_index]->in_use)
 		dbg->fatal("RELEASE_NODE","called while list free");
-	_nodes_in_use[nodes_index] = false;
+	(*_node_pools)[nodes_index]->in_use = false;
+}
+
+/**
+ * Private car checker helper: follows the road on from the freshly created node k
+ * for as long as it neither branches nor reaches a possible destination, so that
+ * these tiles do not have to pass through the heap one by one. The tiles passed
+ * are closed at once: with exactly one way in and one way out, any other route
+ * through them could only lead back to the already closed tile we came from.
+ * @return the node at the junction, destination or dead end to be queued instead of k
+ */
+static route_t::ANode *follow_road_section(route_t::ANode *k, route_t::node_pool_t *nodes, uint32 &step, marker_t &marker, test_driver_t *tdriver, const koord3d start, const uint32 max_khm, const uint32 max_depth, const bool is_tall)
+{
+	while(  step < route_t::MAX_STEP  ) {
+		const grund_t *gr = k->gr;
+		const weg_t *w = gr->get_weg(road_wt);
+		if(  w == NULL  ||  !ribi_t::is_twoway(w->get_ribi_unmasked())  ||  tdriver->is_target(gr, k->parent->gr)  ) {
+			break;
+		}
+
+		// the only way on apart from the way back
+		const ribi_t::ribi next_dir = tdriver->get_ribi(gr) & w->get_ribi_unmasked() & ~ribi_t::backward(k->ribi_from);
+		grund_t *to = NULL;
+		if(  !ribi_t::is_single(next_dir)
+			||  koord_distance(start, gr->get_pos() + koord(next_dir)) >= max_depth
+			||  !gr->get_neighbour(to, road_wt, next_dir)
+			||  marker.is_marked(to)
+			||  !tdriver->check_next_tile(to)
+			||  (is_tall  &&  to->is_height_restricted())  ) {
+			break;
+		}
+
+		marker.mark(gr);
+
+		route_t::ANode *n = nodes->alloc();
+		step++;
+		if (route_t::max_used_steps < step)
+		{
+			route_t::max_used_steps = step;
+		}
+
+		// same costs as in find_route()
+		n->parent = k;
+		n->gr = to;
+		n->count = k->count+1;
+		n->f = 0;
+		n->g = k->g + tdriver->get_cost(to, max_khm, next_dir);
+		n->ribi_from = next_dir;
+
+		const uint8 current_dir = next_dir | k->ribi_from;
+		if(k->dir!=current_dir) {
+			n->g += 3;
+			if(ribi_t::is_perpendicular(k->dir,current_dir)) {
+				// discourage v turns heavily
+				n->g += 25;
+			}
+			else if(k->parent->dir!=k->dir  &&  k->parent->parent!=NULL) {
+				// discourage 90 degree turns
+				n->g += 10;
+			}
+		}
+		n->dir = current_dir;
+		k = n;
+	}
+	return k;
 }
 
 /**
@@ -438,16 +506,12 @@ bool route_t::find_route(karte_t *welt, const koord3d start, test_driver_t *tdri
 		return false;
 	}
 
-	ANode *nodes;
-	uint8 ni = GET_NODES(&nodes);
-
-#ifdef USE_VALGRIND_MEMCHECK
-	VALGRIND_MAKE_MEM_UNDEFINED(nodes, sizeof(ANode)*MAX_STEP);
-#endif
-
+	node_pool_t *nodes;
+	const uint32 ni = GET_NODES(&nodes);
 
 	uint32 step = 0;
-	ANode* tmp = &nodes[step++];
+	ANode* tmp = nodes->alloc();
+	step++;
 	if (route_t::max_used_steps < step)
 	{
 		route_t::max_used_steps = step;
@@ -854,7 +918,8 @@ bool route_t::find_route(karte_t *welt, const koord3d start, test_driver_t *tdri
 				}
 
 				// not in there or taken out => add new
-				ANode* k = &nodes[step++];
+				ANode* k = nodes->alloc();
+				step++;
 				if (route_t::max_used_steps < step)
 				{
 					route_t::max_used_steps = step;
@@ -896,6 +961,12 @@ bool route_t::find_route(karte_t *welt, const koord3d start, test_driver_t *tdri
 				}
 				k->dir = current_dir;
 
+				if(flags == private_car_checker)
+				{
+					// plain road between junctions: no need to queue every tile
+					k = follow_road_section(k, nodes, step, marker, tdriver, start, max_khm, max_depth, is_tall);
+				}
+
 				// insert here
 				queue.insert(k);
 			}
@@ -1007,15 +1078,11 @@ route_t::route_result_t route_t::intern_calc_route(karte_t *welt, const koord3d
 
 	binary_heap_tpl <ANode *> queue;
 
-	ANode *nodes;
-	uint8 ni = GET_NODES(&nodes);
-
-#ifdef USE_VALGRIND_MEMCHECK
-	VALGRIND_MAKE_MEM_UNDEFINED(nodes, sizeof(ANode)*MAX_STEP);
-#endif
+	node_pool_t *nodes;
+	const uint32 ni = GET_NODES(&nodes);
 
 	uint32 step = 0;
-	ANode* tmp = &nodes[step];
+	ANode* tmp = nodes->alloc();
 	step ++;
 	if (route_t::max_used_steps < step)
 		route_t::max_used_steps = step;
@@ -1296,7 +1363,7 @@ route_t::route_result_t route_t::intern_calc_route(karte_t *welt, const koord3d
 				const uint32 new_f = (new_g + dist + turns * 3 + costup) * 10;
 
 				// add new
-				ANode* k = &nodes[step];
+				ANode* k = nodes->alloc();
 				step ++;
 				if (route_t::max_used_steps < step)
 					route_t::max_used_steps = step;
@@ -15,6 +15,12 @@
 
 #include "../utils/simthread.h"
 
+// define USE_VALGRIND_MEMCHECK to make
+// valgrind aware of the memory pool for A* nodes
+#ifdef USE_VALGRIND_MEMCHECK
+#include <valgrind/memcheck.h>
+#endif
+
 class karte_t;
 class test_driver_t;
 class grund_t;
@@ -84,16 +90,61 @@ public:
 		inline bool operator <= (const ANode &k) const { return f==k.f ? g<=k.g : f<=k.f; }
 	};
 
+	/**
+	 * Node storage for one search. Nodes are handed out from fixed size blocks,
+	 * which are only allocated once a search actually reaches them and are kept
+	 * for the next search. Hence memory follows the largest search done so far
+	 * rather than MAX_STEP, and node addresses stay valid while the pool grows.
+	 * Starting a new search only rewinds the fill position; nodes are never cleared,
+	 * but valgrind is told that the reused ones are undefined again.
+	 */
+	class node_pool_t {
+	public:
+		static const uint32 NODES_PER_BLOCK = 4096;
+
+	private:
+		vector_tpl<ANode *> blocks;
+		uint32 next_block;    ///< block to continue with once the current one is full
+		ANode *next_node;
+		uint32 free_in_block;
+
+	public:
+		bool in_use;
+
+		node_pool_t() : next_block(0), next_node(NULL), free_in_block(0), in_use(false) {}
+		~node_pool_t();
+
+		/// forget all nodes handed out so far
+		void rewind() { next_block = 0; next_node = NULL; free_in_block = 0; }
+
+		inline ANode *alloc()
+		{
+			if(  free_in_block == 0  ) {
+				if(  next_block == blocks.get_count()  ) {
+					blocks.append( new ANode[NODES_PER_BLOCK] );
+				}
+				next_node = blocks[next_block++];
+				free_in_block = NODES_PER_BLOCK;
+#ifdef USE_VALGRIND_MEMCHECK
+				VALGRIND_MAKE_MEM_UNDEFINED(next_node, sizeof(ANode)*NODES_PER_BLOCK);
+#endif
+			}
+			free_in_block--;
+			return next_node++;
+		}
+
+		uint32 get_allocated_nodes() const { return blocks.get_count() * NODES_PER_BLOCK; }
+	};
+
 private:
-	static const uint8 MAX_NODES_ARRAY = 2;
-	static thread_local ANode *_nodes[MAX_NODES_ARRAY];
-	static thread_local bool _nodes_in_use[MAX_NODES_ARRAY]; // semaphores, since we only have few nodes arrays in memory
+	/// one pool per search running on this thread; grows if searches are nested
+	static thread_local vector_tpl<node_pool_t *> *_node_pools;
 public:
 	static thread_local uint32 MAX_STEP;
 	static thread_local uint32 max_used_steps;
 	static void INIT_NODES(uint32 max_route_steps, const koord &world_size);
-	static uint8 GET_NODES(ANode **nodes);
-	static void RELEASE_NODES(uint8 nodes_index);
+	static uint32 GET_NODES(node_pool_t **nodes);
+	static void RELEASE_NODES(uint32 nodes_index);
 	static void TERM_NODES(void* args = NULL);
 
 	static bool suspend_private_car_routing;
@@ -2039,6 +2039,8 @@ void settings_t::parse_simuconf( tabfile_t& simuconf, sint16& disp_width, sint16
 	env_t::ground_object_probability = contents.get_int_clamped( "random_grounds_probability",  env_t::ground_object_probability, 0, INT_MAX);
 	env_t::moving_object_probability = contents.get_int_clamped( "random_wildlife_probability", env_t::moving_object_probability, 0, INT_MAX);
 
+	env_t::pak_cache = contents.get_int( "pak_cache", env_t::pak_cache ) != 0;
+
 	env_t::straight_way_without_control = contents.get_int( "straight_way_without_control", env_t::straight_way_without_control ) != 0;
 
 	// try to read pedestrian_info and privatecar_info. If neither is found, try to fallback to pedes_and_car_info. If not found, do not override the existing value.
@@ -1238,6 +1238,7 @@ public:
 
 #ifndef NETTOOL
 	float32e8_t get_simtime_factor() const { return simtime_factor; }
+	float32e8_t get_steps_per_meter() const { return steps_per_meter; }
 	float32e8_t meters_to_steps(const float32e8_t &meters) const { return steps_per_meter * meters; }
 	float32e8_t steps_to_meters(const float32e8_t &steps) const { return meters_per_step * steps; }
 	float32e8_t ticks_to_seconds(sint32 delta_t) const { return seconds_per_tick * delta_t; }
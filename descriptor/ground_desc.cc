@@ -12,6 +12,7 @@
 #include "spezial_obj_tpl.h"
 #include "ground_desc.h"
 #include "../dataobj/environment.h"
+#include "../dataobj/pak_cache.h"
 
 //const int totalslopes_single = 16;
 const int totalslopes = 81;
@@ -592,6 +593,33 @@ char const* ground_desc_t::get_climate_name_from_bit(climate n)
 }
 
 
+#if COLOUR_DEPTH != 0
+// image ids of the calculated textures (except water_image, which is always image_offset)
+static const uint32 cached_ground_ids = (number_of_climates + 1) + totalslopes + 2 * totalslopes * 15;
+
+/* copies the image ids of the calculated textures from or to the pak cache,
+ * where they are stored relative to image_offset
+ */
+static void copy_cached_ground_ids(uint32 *ids, image_id offset, bool loading)
+{
+	image_id *const tables[] = { climate_image, alpha_image, alpha_corners_image, alpha_water_image };
+	const uint32 sizes[] = { number_of_climates + 1, totalslopes, totalslopes * 15, totalslopes * 15 };
+	uint32 n = 0;
+	for(  uint32 t = 0;  t < lengthof(tables);  t++  ) {
+		for(  uint32 i = 0;  i < sizes[t];  i++, n++  ) {
+			if(  loading  ) {
+				tables[t][i] = ids[n] == IMG_EMPTY ? IMG_EMPTY : ids[n] + offset;
+			}
+			else {
+				ids[n] = tables[t][i] == IMG_EMPTY ? IMG_EMPTY : tables[t][i] - offset;
+			}
+		}
+	}
+	assert(n == cached_ground_ids);
+}
+#endif
+
+
 void ground_desc_t::init_ground_textures(karte_t *world)
 {
 	ground_desc_t::world = world;
@@ -635,6 +663,16 @@ void ground_desc_t::init_ground_textures(karte_t *world)
 	// double slope needs full climates
 	assert(!double_grounds  ||  full_climate);
 
+#if COLOUR_DEPTH != 0
+	// besides the pak files, the textures depend only on these
+	const uint32 cache_key = (uint8)TILE_HEIGHT_STEP | ((uint32)water_animation_stages << 8) | ((uint32)double_grounds << 24) | ((uint32)full_climate << 25);
+	vector_tpl<image_t *> cached_images;
+	uint32 cached_ids[cached_ground_ids];
+	const bool from_cache = pak_cache_t::read_images("ground", cache_key, cached_images, cached_ids, cached_ground_ids);
+#else
+	const bool from_cache = false;
+#endif
+
 	// calculate the matching slopes ...
 	doubleslope_to_imgnr[0] = 0;
 	for(  int slope = 1, slopeimgnr=1;  slope < totalslopes;  slope++  ) {
@@ -651,6 +689,11 @@ void ground_desc_t::init_ground_textures(karte_t *world)
 		// now add this image
 		doubleslope_to_imgnr[slope] = slopeimgnr++;
 
+		if(  from_cache  ) {
+			// the transitions are only needed to calculate the textures
+			continue;
+		}
+
 		image_t *tmp_pic = NULL;
 		switch(  slope  ) {
 			case slope_t::north: {
@@ -987,6 +1030,19 @@ void ground_desc_t::init_ground_textures(karte_t *world)
 	// water images for water and overlay
 	water_image = image_offset;
 
+#if COLOUR_DEPTH != 0
+	if(  from_cache  ) {
+		// registering in the same order gives the same image ids as calculating them
+		for(image_t* const image : cached_images) {
+			image->register_image();
+			ground_image_list.append( image );
+		}
+		copy_cached_ground_ids( cached_ids, image_offset, true );
+		DBG_DEBUG("ground_desc_t::init_ground_textures()", "Init ground textures from cache successful");
+		return;
+	}
+#endif
+
 	image_t **water_stage_texture = new image_t*[water_animation_stages];
 	for(uint16 stage = 0; stage < water_animation_stages; stage++) {
 		water_stage_texture[stage] = create_texture_from_tile(sea->get_image_ptr(0 /*depth*/, stage), boden_texture->get_image_ptr(water_climate));
@@ -1069,6 +1125,13 @@ void ground_desc_t::init_ground_textures(karte_t *world)
 	}
 
 #if COLOUR_DEPTH != 0
+	// keep them for the next start
+	for(image_t* const image : ground_image_list) {
+		cached_images.append( image );
+	}
+	copy_cached_ground_ids( cached_ids, image_offset, false );
+	pak_cache_t::write_images( "ground", cache_key, cached_images, cached_ids, cached_ground_ids );
+
 	// free the helper bitmap
 	for(  int slope = 1;  slope < totalslopes;  slope++  ) {
 		delete all_rotations_slope[slope];
@@ -20,6 +20,7 @@
 // normal stuff
 #include "../../dataobj/translator.h"
 #include "../../dataobj/environment.h"
+#include "../../dataobj/pak_cache.h"
 
 #include "../../utils/searchfolder.h"
 #include "../../utils/simstring.h"
@@ -34,6 +35,16 @@
 
 #include "obj_reader.h"
 
+#ifdef MULTI_THREAD
+#include "../../utils/simthread.h"
+
+// the pak files are only read ahead where the system can be asked to do so without copying them
+#if defined(_POSIX_ADVISORY_INFO) && _POSIX_ADVISORY_INFO > 0
+#include <fcntl.h>
+#define PAK_PREFETCH
+#endif
+#endif
+
 
 obj_reader_t::obj_map*                                        obj_reader_t::obj_reader;
 inthashtable_tpl<obj_type, stringhashtable_tpl<obj_desc_t*, N_BAGS_LARGE>, N_BAGS_LARGE> obj_reader_t::loaded;
@@ -70,6 +81,104 @@ bool obj_reader_t::finish_rd()
 }
 
 
+#ifdef PAK_PREFETCH
+/**
+ * The pak files are parsed one after another on the main thread, since the order
+ * of registration decides which object wins if names are used twice. These threads
+ * ask the system to read the following files into the file cache, so the parser
+ * does not wait for the disk. Files already cached are not touched again.
+ * They stay at most AHEAD files in front of the parser.
+ */
+class pak_prefetcher_t
+{
+	enum { AHEAD = 64 };
+
+	char *const *files;
+	uint32 count;
+	uint32 next;   ///< next file to be read ahead
+	uint32 parsed; ///< number of files the parser is done with
+	bool stop;
+
+	pthread_mutex_t mutex;
+	pthread_cond_t cond;
+	vector_tpl<pthread_t> threads;
+
+	static void *prefetch_thread(void *ptr)
+	{
+		pak_prefetcher_t *pf = (pak_prefetcher_t *)ptr;
+
+		pthread_mutex_lock(&pf->mutex);
+		while(  true  ) {
+			while(  !pf->stop  &&  pf->next < pf->count  &&  pf->next >= pf->parsed + AHEAD  ) {
+				pthread_cond_wait(&pf->cond, &pf->mutex);
+			}
+			if(  pf->stop  ||  pf->next >= pf->count  ) {
+				break;
+			}
+			const char *name = pf->files[pf->next++];
+			pthread_mutex_unlock(&pf->mutex);
+
+			// opening may already wait for the disk, so this is still done here and not by the parser
+			if(  FILE *const fp = dr_fopen(name, "rb")  ) {
+				posix_fadvise(fileno(fp), 0, 0, POSIX_FADV_WILLNEED);
+				fclose(fp);
+			}
+
+			pthread_mutex_lock(&pf->mutex);
+		}
+		pthread_mutex_unlock(&pf->mutex);
+
+		return NULL;
+	}
+
+public:
+	pak_prefetcher_t(char *const *begin, char *const *end) :
+		files(begin),
+		count((uint32)(end - begin)),
+		next(0),
+		parsed(0),
+		stop(false)
+	{
+		pthread_mutex_init(&mutex, NULL);
+		pthread_cond_init(&cond, NULL);
+
+		// the main thread is busy parsing, reading ahead needs only few threads;
+		// with a single thread configured, nothing is read ahead
+		const int num_threads = min(env_t::num_threads - 1, 4);
+		for(  int i = 0;  i < num_threads  &&  count > 1;  i++  ) {
+			pthread_t thread;
+			if(  pthread_create(&thread, NULL, &prefetch_thread, this) == 0  ) {
+				threads.append(thread);
+			}
+		}
+	}
+
+	~pak_prefetcher_t()
+	{
+		pthread_mutex_lock(&mutex);
+		stop = true;
+		pthread_cond_broadcast(&cond);
+		pthread_mutex_unlock(&mutex);
+
+		for(pthread_t thread : threads) {
+			pthread_join(thread, NULL);
+		}
+		pthread_cond_destroy(&cond);
+		pthread_mutex_destroy(&mutex);
+	}
+
+	/// the parser is done with the first @p n files
+	void set_parsed(uint32 n)
+	{
+		pthread_mutex_lock(&mutex);
+		parsed = n;
+		pthread_cond_broadcast(&cond);
+		pthread_mutex_unlock(&mutex);
+	}
+};
+#endif
+
+
 bool obj_reader_t::load(const char *path, const char *message)
 {
 	searchfolder_t find;
@@ -147,9 +256,16 @@ DBG_MESSAGE("obj_reader_t::load()","big logo %p", skinverwaltung_t::biglogosymbo
 
 DBG_MESSAGE("obj_reader_t::load()", "reading from '%s'", name.c_str());
 
+#ifdef PAK_PREFETCH
+		pak_prefetcher_t prefetcher(find.begin(), find.end());
+#endif
+
 		uint n = 0;
 		for(char* const& i : find) {
 			read_file(i);
+#ifdef PAK_PREFETCH
+			prefetcher.set_parsed(n+1);
+#endif
 			if ((n++ & step) == 0 && drawing) {
 				ls.set_progress(n);
 			}
@@ -170,6 +286,8 @@ void obj_reader_t::read_file(const char *name)
 	if (FILE* const fp = dr_fopen(name, "rb")) {
 		sint32 n = 0;
 
+		pak_cache_t::add_file(name);
+
 		// This is the normal header reading code
 		int c;
 		do {
@@ -141,6 +141,7 @@ scr_coord_val display_set_base_raster_width(scr_coord_val new_raster);
 int zoom_factor_up();
 int zoom_factor_down();
 int get_zoom_factor();
+void set_zoom_factor(int z);
 
 /**
  * Initialises the graphics module
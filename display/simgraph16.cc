@@ -44,6 +44,12 @@
 #	include <unistd.h>
 #endif
 
+// SSE2 is part of every x86-64 processor, so no check at runtime is needed
+#if defined __SSE2__  ||  defined _M_X64  ||  (defined _M_IX86_FP  &&  _M_IX86_FP >= 2)
+#	define USE_SSE2_BLIT
+#	include <emmintrin.h>
+#endif
+
 #ifdef MULTI_THREAD
 #include "../utils/simthread.h"
 
@@ -347,6 +353,7 @@ struct imd {
 
 	PIXVAL* zoom_data; // zoomed original data
 	uint32 len;    // current zoom image data size (or base if not zoomed) (used for allocation purposes only)
+	uint8 zoom_level; // zoom factor zoom_data was calculated for
 
 	sint16 base_x; // min x offset
 	sint16 base_y; // min y offset
@@ -377,6 +384,28 @@ static uint8 *rezoom_baseimage[MAX_THREADS];
 static PIXVAL *rezoom_baseimage2[MAX_THREADS];
 static size_t rezoom_size[MAX_THREADS];
 
+/*
+ * The zoomed images of the last left zoom levels, so zooming back does not need
+ * to calculate them again. rezoom_img() takes the images out of here again.
+ */
+#define ZOOM_CACHE_LEVELS (3)
+
+struct zoom_cache_img_t {
+	PIXVAL *data;
+	uint32 len;
+	sint16 x, y, w, h;
+};
+
+struct zoom_cache_level_t {
+	int zoom;              // -1 for unused
+	uint32 last_used;
+	uint32 count;          // size of img
+	zoom_cache_img_t *img; // indexed by image_id
+};
+
+static zoom_cache_level_t zoom_cache[ZOOM_CACHE_LEVELS] = { { -1, 0, 0, NULL }, { -1, 0, 0, NULL }, { -1, 0, 0, NULL } };
+static uint32 zoom_cache_clock = 0;
+
 /*
  * Image table
  */
@@ -971,6 +1000,71 @@ void display_mark_img_dirty(image_id image, scr_coord_val xp, scr_coord_val yp)
  * They are derived from a base image, which may need zooming too
  */
 
+static void zoom_cache_free_level(zoom_cache_level_t &level)
+{
+	for(  uint32 n = 0;  n < level.count;  n++  ) {
+		free( level.img[n].data );
+	}
+	free( level.img );
+	level.img = NULL;
+	level.count = 0;
+	level.zoom = -1;
+}
+
+
+/**
+ * Move the zoomed images of the zoom level we leave into the cache,
+ * replacing the level left longest ago if all are used
+ */
+static void zoom_cache_store(int zoom)
+{
+	if(  zoom == ZOOM_NEUTRAL  ) {
+		// uses the base images anyway
+		return;
+	}
+
+	zoom_cache_level_t *level = NULL;
+	for(  int i = 0;  i < ZOOM_CACHE_LEVELS  &&  level == NULL;  i++  ) {
+		if(  zoom_cache[i].zoom == zoom  ) {
+			level = &zoom_cache[i];
+		}
+	}
+	if(  level == NULL  ) {
+		level = &zoom_cache[0];
+		for(  int i = 1;  i < ZOOM_CACHE_LEVELS;  i++  ) {
+			if(  zoom_cache[i].last_used < level->last_used  ) {
+				level = &zoom_cache[i];
+			}
+		}
+		zoom_cache_free_level( *level );
+		level->zoom = zoom;
+	}
+	level->last_used = ++zoom_cache_clock;
+
+	if(  level->count < anz_images  ) {
+		level->img = REALLOC( level->img, zoom_cache_img_t, anz_images );
+		memset( level->img + level->count, 0, (anz_images - level->count) * sizeof(zoom_cache_img_t) );
+		level->count = anz_images;
+	}
+
+	for(  image_id n = 0;  n < anz_images;  n++  ) {
+		imd &img = images[n];
+		// only images really zoomed for this level (not fitted to some width)
+		if(  img.zoom_data != NULL  &&  img.zoom_level == zoom  &&  (img.recode_flags & FLAG_ZOOMABLE) != 0  ) {
+			zoom_cache_img_t &cached = level->img[n];
+			free( cached.data );
+			cached.data = img.zoom_data;
+			cached.len = img.len;
+			cached.x = img.x;
+			cached.y = img.y;
+			cached.w = img.w;
+			cached.h = img.h;
+			img.zoom_data = NULL;
+		}
+	}
+}
+
+
 /**
  * Flag all images for rezoom on next draw
  */
@@ -992,6 +1086,9 @@ void set_zoom_factor(int z)
 {
 	// do not zoom beyond 4 pixels
 	if(  (base_tile_raster_width * zoom_num[z]) / zoom_den[z] > 4  ) {
+		if(  z != (int)zoom_factor  ) {
+			zoom_cache_store( zoom_factor );
+		}
 		zoom_factor = z;
 		tile_raster_width = (base_tile_raster_width * zoom_num[zoom_factor]) / zoom_den[zoom_factor];
 		dbg->message("set_zoom_factor()", "Zoom level now %d (%i/%i)", zoom_factor, zoom_num[zoom_factor], zoom_den[zoom_factor] );
@@ -1225,6 +1322,28 @@ static void rezoom_img(const image_id n)
 			}
 		}
 
+		// zoomed already before we left this level?
+		if(  zoom_factor != ZOOM_NEUTRAL  &&  (images[n].recode_flags&FLAG_ZOOMABLE) != 0  ) {
+			for(  int i = 0;  i < ZOOM_CACHE_LEVELS;  i++  ) {
+				if(  zoom_cache[i].zoom == (int)zoom_factor  &&  n < zoom_cache[i].count  &&  zoom_cache[i].img[n].data != NULL  ) {
+					zoom_cache_img_t &cached = zoom_cache[i].img[n];
+					images[n].zoom_data = cached.data;
+					images[n].zoom_level = zoom_factor;
+					images[n].len = cached.len;
+					images[n].x = cached.x;
+					images[n].y = cached.y;
+					images[n].w = cached.w;
+					images[n].h = cached.h;
+					cached.data = NULL;
+					images[n].recode_flags &= ~FLAG_REZOOM;
+#ifdef MULTI_THREAD
+					pthread_mutex_unlock( &rezoom_img_mutex[n % env_t::num_threads] );
+#endif
+					return;
+				}
+			}
+		}
+
 		// just restore original size?
 		if(  zoom_factor == ZOOM_NEUTRAL  ||  (images[n].recode_flags&FLAG_ZOOMABLE) == 0  ) {
 			// this we can do be a simple copy ...
@@ -1658,6 +1777,7 @@ static void rezoom_img(const image_id n)
 				const size_t zoom_len = (size_t)(((uint8 *)dest) - ((uint8 *)rezoom_baseimage[n % env_t::num_threads]));
 				images[n].len = (uint32)(zoom_len / sizeof(PIXVAL));
 				images[n].zoom_data = MALLOCN(PIXVAL, images[n].len);
+				images[n].zoom_level = zoom_factor;
 				assert( images[n].zoom_data );
 				memcpy( images[n].zoom_data, rezoom_baseimage[n % env_t::num_threads], zoom_len );
 			}
@@ -1899,6 +2019,7 @@ void register_image(image_t *image_in)
 	}
 
 	image->zoom_data = NULL;
+	image->zoom_level = 0xFF;
 	image->len = image_in->len;
 
 	image->base_x = image_in->x;
@@ -1918,6 +2039,14 @@ void register_image(image_t *image_in)
 // (mostly needed when changing climate zones)
 void display_free_all_images_above( image_id above )
 {
+	// the new images at these numbers will be different
+	for(  int i = 0;  i < ZOOM_CACHE_LEVELS;  i++  ) {
+		for(  uint32 n = above;  n < zoom_cache[i].count;  n++  ) {
+			free( zoom_cache[i].img[n].data );
+			zoom_cache[i].img[n].data = NULL;
+		}
+	}
+
 	while(  above < anz_images  ) {
 		anz_images--;
 		if(  images[anz_images].zoom_data != NULL  ) {
@@ -1965,6 +2094,14 @@ PIXVAL colors_blend_alpha32(PIXVAL background, PIXVAL foreground, int alpha);
  */
 static inline void pixcopy(PIXVAL *dest, const PIXVAL *src, const PIXVAL * const end)
 {
+#ifdef USE_SSE2_BLIT
+	// eight pixels at once, neither image data nor screen are aligned
+	while(  end - src >= 8  ) {
+		_mm_storeu_si128( (__m128i *)dest, _mm_loadu_si128( (const __m128i *)src ) );
+		dest += 8;
+		src += 8;
+	}
+#endif
 	// for gcc this seems to produce the optimal code ...
 	while (src < end) {
 		*dest++ = *src++;
@@ -2172,7 +2309,11 @@ static void display_img_nc(scr_coord_val h, const scr_coord_val xp, const scr_co
 					sp += runlen;
 				}
 				else {
-#ifdef LOW_LEVEL
+#if defined USE_SSE2_BLIT
+					pixcopy( p, sp, sp + runlen );
+					p += runlen;
+					sp += runlen;
+#elif defined LOW_LEVEL
 #ifdef SIM_BIG_ENDIAN
 					// low level c++ without any unrolling
 					while(  runlen--  ) {
@@ -5184,6 +5325,9 @@ void simgraph_exit()
 	free( tile_dirty );
 	display_free_all_images_above(0);
 	free(images);
+	for(  int i = 0;  i < ZOOM_CACHE_LEVELS;  i++  ) {
+		zoom_cache_free_level( zoom_cache[i] );
+	}
 
 	tile_dirty = tile_dirty_old = NULL;
 	images = NULL;
@@ -52,31 +52,20 @@ bool spawned_threads=false; // global job indicator array
 static simthread_barrier_t display_barrier_start;
 static simthread_barrier_t display_barrier_end;
 
-// to start a thread
+// parameters of the current frame, the same for all threads
 typedef struct{
 	main_view_t *show_routine;
-	koord   lt_cl, wh_cl; // pos/size of clipping rect for this thread
-	koord   lt, wh;       // pos/size of region to display. set larger than clipping for correct display of trees at thread seams
+	scr_rect clip_rr;   // area to display
 	sint16  y_min;
 	sint16  y_max;
-	sint8   thread_num;
+	sint16  num_strips; // the area is split into this many vertical strips
 } display_region_param_t;
 
-// now the parameters
-static display_region_param_t ka[MAX_THREADS];
+static display_region_param_t ka;
 
-void *display_region_thread( void *ptr )
-{
-	display_region_param_t *view = reinterpret_cast<display_region_param_t *>(ptr);
-
-	while(true) {
-		simthread_barrier_wait( &display_barrier_start ); // wait for all to start
-		clear_all_poly_clip( view->thread_num );
-		display_set_clip_wh( view->lt_cl.x, view->lt_cl.y, view->wh_cl.x, view->wh_cl.y, view->thread_num );
-		view->show_routine->display_region( view->lt, view->wh, view->y_min, view->y_max, false, true, view->thread_num );
-		simthread_barrier_wait( &display_barrier_end ); // wait for all to finish
-	}
-}
+// next strip to draw, protected by strip_mutex
+static sint16 next_strip = 0;
+static pthread_mutex_t strip_mutex = PTHREAD_MUTEX_INITIALIZER;
 
 /* The following mutex is only needed for smart cursor */
 // mutex for changing settings on hiding buildings/trees
@@ -86,8 +75,54 @@ static uint8 num_threads_paused = 0; // number of threads in the paused state
 static pthread_cond_t hiding_cond = PTHREAD_COND_INITIALIZER;
 static pthread_cond_t waiting_cond = PTHREAD_COND_INITIALIZER;
 
+/* Draws strips until none is left. There are more strips than threads and
+ * each thread takes the next one as soon as it is done with the last. Hence a
+ * strip full of buildings does not keep all other threads waiting.
+ */
+static void display_strips( const sint8 thread_num )
+{
+	const sint16 IMG_SIZE = get_tile_raster_width();
+
+	while(  true  ) {
+		pthread_mutex_lock( &strip_mutex );
+		const sint16 strip = next_strip++;
+		pthread_mutex_unlock( &strip_mutex );
+		if(  strip >= ka.num_strips  ) {
+			break;
+		}
+
+		// the last strip ends at the screen edge, whatever the rounding
+		const scr_coord_val left  = ka.clip_rr.x + (ka.clip_rr.w * strip) / ka.num_strips;
+		const scr_coord_val right = ka.clip_rr.x + (ka.clip_rr.w * (strip + 1)) / ka.num_strips;
+		clear_all_poly_clip( thread_num );
+		display_set_clip_wh( left, ka.clip_rr.y, right - left, ka.clip_rr.h, thread_num );
+		// process tiles IMG_SIZE/2 outside clipping range for correct tree display at strip seams
+		ka.show_routine->display_region( koord( left - IMG_SIZE / 2, ka.clip_rr.y ), koord( right - left + IMG_SIZE, ka.clip_rr.h ), ka.y_min, ka.y_max, false, true, thread_num );
+	}
+
+	// show thread as paused when finished
+	pthread_mutex_lock( &hide_mutex );
+	num_threads_paused++;
+	pthread_cond_broadcast( &waiting_cond );
+	pthread_mutex_unlock( &hide_mutex );
+}
+
+void *display_region_thread( void *ptr )
+{
+	const sint8 thread_num = *reinterpret_cast<sint8 *>(ptr);
+
+	while(true) {
+		simthread_barrier_wait( &display_barrier_start ); // wait for all to start
+		display_strips( thread_num );
+		simthread_barrier_wait( &display_barrier_end ); // wait for all to finish
+	}
+}
+
 #if COLOUR_DEPTH != 0
 static bool can_multithreading = true;
+
+// the thread numbers, also the clip_num of each thread
+static sint8 thread_nums[MAX_THREADS];
 #endif
 #endif
 
@@ -216,7 +251,8 @@ void main_view_t::display(bool force_dirty)
 			simthread_barrier_init( &display_barrier_end, NULL, env_t::num_threads );
 
 			for(  int t = 0;  t < env_t::num_threads - 1;  t++  ) {
-				if(  pthread_create( &thread[t], &attr, display_region_thread, (void *)&ka[t] )  ) {
+				thread_nums[t] = t;
+				if(  pthread_create( &thread[t], &attr, display_region_thread, (void *)&thread_nums[t] )  ) {
 					can_multithreading = false;
 					dbg->error( "main_view_t::display()", "cannot multi-thread, error at thread #%i", t+1 );
 					return;
@@ -226,33 +262,22 @@ void main_view_t::display(bool force_dirty)
 			pthread_attr_destroy( &attr );
 		}
 
-		// set parameter for each thread
-		const scr_coord_val wh_x = clip_rr.w / env_t::num_threads;
-		scr_coord_val lt_x = clip_rr.x;
-		for(  int t = 0;  t < env_t::num_threads - 1;  t++  ) {
-			ka[t].show_routine = this;
-			ka[t].lt_cl = koord( lt_x, clip_rr.y );
-			ka[t].wh_cl = koord( wh_x, clip_rr.h );
-			ka[t].lt = ka[t].lt_cl - koord( IMG_SIZE/2, 0 ); // process tiles IMG_SIZE/2 outside clipping range for correct tree display at thread seams
-			ka[t].wh = ka[t].wh_cl + koord( IMG_SIZE, 0 );
-			ka[t].y_min = y_min;
-			ka[t].y_max = dpy_height + 4 * 4;
-			ka[t].thread_num = t;
-			lt_x += wh_x;
-		}
+		// set parameters for this frame
+		ka.show_routine = this;
+		ka.clip_rr = clip_rr;
+		ka.y_min = y_min;
+		ka.y_max = dpy_height + 4 * 4;
+		// up to four strips per thread, but each seam costs a column of tiles drawn twice
+		ka.num_strips = (sint16)clamp<scr_coord_val>( clip_rr.w / (IMG_SIZE * 2), env_t::num_threads, env_t::num_threads * 4 );
+		next_strip = 0;
 
 		// init variables required to draw smart cursor
 		threads_req_pause = false;
 		num_threads_paused = 0;
 
-		// and start drawing
+		// and start drawing, this thread helps as the last one
 		simthread_barrier_wait( &display_barrier_start );
-
-		// the last we can run ourselves, setting clip_wh to the screen edge instead of wh_x (in case disp_width % num_threads != 0)
-		clear_all_poly_clip( env_t::num_threads - 1 );
-		display_set_clip_wh( lt_x, clip_rr.y, clip_rr.w, clip_rr.h, env_t::num_threads - 1 );
-		display_region( koord( lt_x - IMG_SIZE / 2, clip_rr.y ), koord( clip_rr.x + clip_rr.w + IMG_SIZE, clip_rr.h ), y_min, dpy_height + 4 * 4, false, true, env_t::num_threads - 1 );
-
+		display_strips( env_t::num_threads - 1 );
 		simthread_barrier_wait( &display_barrier_end );
 
 		clear_all_poly_clip( 0 );
@@ -365,6 +390,17 @@ void main_view_t::clear_prepared() const
 }
 
 
+/* Returns the first x of a row worth looking at for a region starting at left_x,
+ * since the tiles left of it cannot reach into the region. The parity of the row
+ * is kept. Saves going through all the tiles left of the region for each strip.
+ */
+static inline sint16 get_first_column( sint16 x, scr_coord_val left_x, sint16 IMG_SIZE, int const_x_off )
+{
+	const sint16 x_skip = (left_x - IMG_SIZE - const_x_off) / (IMG_SIZE / 2) - 1;
+	return x_skip > x ? x + ((x_skip - x) & ~1) : x;
+}
+
+
 #ifdef MULTI_THREAD
 void main_view_t::display_region( koord lt, koord wh, sint16 y_min, sint16 y_max, bool /*force_dirty*/, bool threaded, const sint8 clip_num )
 #else
@@ -392,7 +428,7 @@ void main_view_t::display_region( koord lt, koord wh, sint16 y_min, sint16 y_max
 		// plotted = we plotted something
 		bool plotted = false;
 
-		for(  sint16 x = -2 - ((y  +dpy_width) & 1);  (x * (IMG_SIZE / 2) + const_x_off) < (lt.x + wh.x);  x += 2  ) {
+		for(  sint16 x = get_first_column( -2 - ((y + dpy_width) & 1), lt.x, IMG_SIZE, const_x_off );  (x * (IMG_SIZE / 2) + const_x_off) < (lt.x + wh.x);  x += 2  ) {
 			const sint16 i = ((y + x) >> 1) + i_off;
 			const sint16 j = ((y - x) >> 1) + j_off;
 			const sint16 xpos = x * (IMG_SIZE / 2) + const_x_off;
@@ -468,7 +504,7 @@ void main_view_t::display_region( koord lt, koord wh, sint16 y_min, sint16 y_max
 	for(  int y = y_min;  y < y_max;  y++  ) {
 		const sint16 ypos = y * (IMG_SIZE / 4) + const_y_off;
 
-		for(  sint16 x = -2 - ((y + dpy_width) & 1);  (x * (IMG_SIZE / 2) + const_x_off) < (lt.x + wh.x);  x += 2  ) {
+		for(  sint16 x = get_first_column( -2 - ((y + dpy_width) & 1), lt.x, IMG_SIZE, const_x_off );  (x * (IMG_SIZE / 2) + const_x_off) < (lt.x + wh.x);  x += 2  ) {
 			const int i = ((y + x) >> 1) + i_off;
 			const int j = ((y - x) >> 1) + j_off;
 			const int xpos = x * (IMG_SIZE / 2) + const_x_off;
@@ -579,15 +615,6 @@ void main_view_t::display_region( koord lt, koord wh, sint16 y_min, sint16 y_max
 			}
 		}
 	}
-#ifdef MULTI_THREAD
-	// show thread as paused when finished
-	if(  threaded  ) {
-		pthread_mutex_lock( &hide_mutex );
-		num_threads_paused++;
-		pthread_cond_broadcast( &waiting_cond );
-		pthread_mutex_unlock( &hide_mutex );
-	}
-#endif
 }
 
 
@@ -1188,8 +1188,8 @@ void way_info_t::update_way_info()
 		uint32 cities_count = 0;
 		building_list.clear();
 		for(uint8 i=0;i<5;i++) {
-			for(uint32 j=0;j<road->private_car_routes[road->private_car_routes_currently_reading_element][i].get_count();j++){
-				const koord dest = road->private_car_routes[road->private_car_routes_currently_reading_element][i][j];
+			for(uint32 j=0;j<road->get_private_car_routes(road->private_car_routes_currently_reading_element)[i].get_count();j++){
+				const koord dest = road->get_private_car_routes(road->private_car_routes_currently_reading_element)[i][j];
 				const grund_t* gr_temp = welt->lookup_kartenboden(dest);
 
 				if( gr_temp && gr_temp->get_building() ){
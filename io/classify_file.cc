@@ -31,7 +31,6 @@ bool classify_as_ppm(FILE *f, file_info_t *info);
 bool classify_as_zstd(FILE *f, file_info_t *info);
 bool classify_as_bzip2(FILE *f, file_info_t *info);
 bool classify_as_zip(FILE *f, file_info_t *info);
-bool classify_file_data(rdwr_stream_t *stream, file_info_t *info);
 
 
 file_info_t::file_info_t() :
@@ -10,6 +10,9 @@
 #include "../simtypes.h"
 
 
+class rdwr_stream_t;
+
+
 enum file_classify_status_t {
 	FILE_CLASSIFY_OK = 0,
 	FILE_CLASSIFY_INVALID_ARGS,
@@ -86,5 +89,12 @@ file_classify_status_t classify_file(const char *path, file_info_t *info);
  */
 file_classify_status_t classify_image_file(const char *path, file_info_t *info);
 
+/**
+ * Classify the uncompressed data of a savegame by its header.
+ * @param stream is read up to the end of the header.
+ * @returns true iff the header is valid; then @p info holds version and header size.
+ */
+bool classify_file_data(rdwr_stream_t *stream, file_info_t *info);
+
 
 #endif
@@ -0,0 +1,75 @@
+/*
+ * This file is part of the Simutrans-Extended project under the Artistic License.
+ * (see LICENSE.txt)
+ */
+
+#include "memory_rdwr_stream.h"
+
+#include <cassert>
+#include <cstring>
+#include <new>
+
+
+memory_rdwr_stream_t::memory_rdwr_stream_t(buffer_t &buffer, bool writing) :
+	rdwr_stream_t(writing),
+	buffer(buffer),
+	pos(0)
+{
+	if (writing) {
+		buffer.clear();
+	}
+
+	status = (writing || buffer.len > 0) ? STATUS_OK : STATUS_EOF;
+}
+
+
+size_t memory_rdwr_stream_t::read(void *buf, size_t len)
+{
+	assert(!is_writing());
+	const size_t available = buffer.len - pos;
+
+	if (len <= available) {
+		memcpy(buf, buffer.data + pos, len);
+		pos += len;
+		status = STATUS_OK;
+		return len;
+	}
+	else {
+		memcpy(buf, buffer.data + pos, available);
+		pos += available;
+		status = STATUS_EOF;
+		return available;
+	}
+}
+
+
+size_t memory_rdwr_stream_t::write(const void *buf, size_t len)
+{
+	assert(is_writing());
+
+	if (buffer.len + len > buffer.capacity) {
+		// grow geometrically, a savegame is written in many small pieces
+		size_t new_capacity = buffer.capacity ? buffer.capacity : 1 << 20;
+		while (buffer.len + len > new_capacity) {
+			new_capacity *= 2;
+		}
+
+		char *new_data = new (std::nothrow) char[new_capacity];
+		if (!new_data) {
+			status = STATUS_ERR_FULL;
+			return 0;
+		}
+
+		if (buffer.len > 0) {
+			memcpy(new_data, buffer.data, buffer.len);
+		}
+		delete [] buffer.data;
+		buffer.data = new_data;
+		buffer.capacity = new_capacity;
+	}
+
+	memcpy(buffer.data + buffer.len, buf, len);
+	buffer.len += len;
+	status = STATUS_OK;
+	return len;
+}
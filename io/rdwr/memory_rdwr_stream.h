@@ -0,0 +1,57 @@
+/*
+ * This file is part of the Simutrans-Extended project under the Artistic License.
+ * (see LICENSE.txt)
+ */
+
+#ifndef IO_RDWR_MEMORY_RDWR_STREAM_H
+#define IO_RDWR_MEMORY_RDWR_STREAM_H
+
+
+#include "rdwr_stream.h"
+
+
+/// Reads/writes raw data from/to a block of memory.
+class memory_rdwr_stream_t : public rdwr_stream_t
+{
+public:
+	/// The memory written to or read from. It is not owned by the stream,
+	/// so the data is still there after the stream has been deleted.
+	class buffer_t
+	{
+	public:
+		char *data;
+		size_t len;      ///< bytes used
+		size_t capacity; ///< bytes allocated
+
+		buffer_t() : data(NULL), len(0), capacity(0) {}
+		~buffer_t() { delete [] data; }
+
+		/// Forget the contents, but keep the memory for the next use.
+		void clear() { len = 0; }
+
+		/// Forget the contents and free the memory.
+		void release() { delete [] data; data = NULL; len = capacity = 0; }
+
+	private:
+		buffer_t(const buffer_t&);
+		buffer_t& operator=(const buffer_t&);
+	};
+
+public:
+	/// When writing, @p buffer is cleared first and grows as needed.
+	memory_rdwr_stream_t(buffer_t &buffer, bool writing);
+
+public:
+	/// @copydoc rdwr_stream_t::read
+	size_t read(void *buf, size_t len) OVERRIDE;
+
+	/// @copydoc rdwr_stream_t::write
+	size_t write(const void *buf, size_t len) OVERRIDE;
+
+private:
+	buffer_t &buffer;
+	size_t pos; ///< read position
+};
+
+
+#endif
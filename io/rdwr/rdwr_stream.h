@@ -61,6 +61,11 @@ public:
 	/// @returns Undefined (but not @p len), if an error occurred.
 	virtual size_t write(const void *buf, size_t len) = 0;
 
+	/// Write any data which is still held back and close the file, so that @ref get_status()
+	/// also covers errors while doing so. Called when writing is done, before checking the status.
+	/// The stream must not be used afterwards, except for deleting it.
+	virtual void finish() {}
+
 protected:
 	/// @warning This must be updated to the correct value when @p read() or @p write() or the constructor fails.
 	status_t status;
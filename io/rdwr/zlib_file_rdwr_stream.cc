@@ -6,35 +6,438 @@
 #include "zlib_file_rdwr_stream.h"
 
 #include "../../sys/simsys.h"
+#include "../../dataobj/environment.h"
 #include "../../macros.h"
 #include "../../simdebug.h"
 
+#include <algorithm>
 #include <cassert>
+#include <cstring>
+
+#define ZLIB_BLOCK_SIZE (1 << 20) // 1MiB of uncompressed data per gzip member
+
+#define ZLIB_BLOCK_HEADER_SIZE  (20) // gzip header with the extra field holding the member size
+#define ZLIB_BLOCK_TRAILER_SIZE (8)  // crc32 and uncompressed size
+
+
+// gzip header with FEXTRA set and a subfield 'S','X' of 4 bytes, which are followed by the member size
+static const uint8 zlib_block_header[ZLIB_BLOCK_HEADER_SIZE - 4] = {
+	0x1f, 0x8b, Z_DEFLATED, 4 /* FEXTRA */, 0, 0, 0, 0 /* MTIME */, 0 /* XFL */, 0xff /* OS */,
+	8, 0 /* XLEN */, 'S', 'X', 4, 0 /* SLEN */
+};
+
+
+static void put_uint32(char *p, uint32 v)
+{
+	p[0] = (char)v;
+	p[1] = (char)(v >> 8);
+	p[2] = (char)(v >> 16);
+	p[3] = (char)(v >> 24);
+}
+
+
+static uint32 get_uint32(const char *p)
+{
+	return (uint32)(uint8)p[0] | ((uint32)(uint8)p[1] << 8) | ((uint32)(uint8)p[2] << 16) | ((uint32)(uint8)p[3] << 24);
+}
+
+
+static void compress_block(zlib_file_rdwr_stream_t::block_t &block, int compression)
+{
+	block.ok = false;
+
+	z_stream zs;
+	memset(&zs, 0, sizeof(zs));
+	// raw deflate, the gzip header and trailer are written here
+	if (deflateInit2(&zs, compression, Z_DEFLATED, -MAX_WBITS, 8, Z_DEFAULT_STRATEGY) != Z_OK) {
+		return;
+	}
+
+	const size_t bound = deflateBound(&zs, block.len);
+	delete [] block.zdata;
+	block.zdata = new char[ZLIB_BLOCK_HEADER_SIZE + bound + ZLIB_BLOCK_TRAILER_SIZE];
+
+	zs.next_in   = (Bytef *)block.data;
+	zs.avail_in  = (uInt)block.len;
+	zs.next_out  = (Bytef *)block.zdata + ZLIB_BLOCK_HEADER_SIZE;
+	zs.avail_out = (uInt)bound;
+
+	const int ret = deflate(&zs, Z_FINISH);
+	deflateEnd(&zs);
+	if (ret != Z_STREAM_END) {
+		return;
+	}
+
+	block.zlen = ZLIB_BLOCK_HEADER_SIZE + zs.total_out + ZLIB_BLOCK_TRAILER_SIZE;
+
+	memcpy(block.zdata, zlib_block_header, sizeof(zlib_block_header));
+	put_uint32(block.zdata + sizeof(zlib_block_header), (uint32)block.zlen);
+
+	char *trailer = block.zdata + block.zlen - ZLIB_BLOCK_TRAILER_SIZE;
+	put_uint32(trailer,     (uint32)crc32(0, (const Bytef *)block.data, (uInt)block.len));
+	put_uint32(trailer + 4, (uint32)block.len);
+
+	block.ok = true;
+}
+
+
+static void decompress_block(zlib_file_rdwr_stream_t::block_t &block)
+{
+	block.ok = false;
+
+	z_stream zs;
+	memset(&zs, 0, sizeof(zs));
+	if (inflateInit2(&zs, -MAX_WBITS) != Z_OK) {
+		return;
+	}
+
+	zs.next_in   = (Bytef *)block.zdata + ZLIB_BLOCK_HEADER_SIZE;
+	zs.avail_in  = (uInt)(block.zlen - ZLIB_BLOCK_HEADER_SIZE - ZLIB_BLOCK_TRAILER_SIZE);
+	zs.next_out  = (Bytef *)block.data;
+	zs.avail_out = (uInt)block.len;
+
+	const int ret = inflate(&zs, Z_FINISH);
+	inflateEnd(&zs);
+
+	const char *trailer = block.zdata + block.zlen - ZLIB_BLOCK_TRAILER_SIZE;
+	block.ok = ret == Z_STREAM_END  &&  zs.total_out == block.len  &&
+		get_uint32(trailer) == (uint32)crc32(0, (const Bytef *)block.data, (uInt)block.len);
+}
+
+
+#ifdef MULTI_THREAD
+enum {
+	WORK_COMPRESS,
+	WORK_DECOMPRESS,
+	WORK_QUIT
+};
+
+
+void *zlib_file_rdwr_stream_t::worker_thread(void *ptr)
+{
+	const worker_param_t *param = (const worker_param_t *)ptr;
+	zlib_file_rdwr_stream_t *stream = param->stream;
+
+	uint32 generation = 0;
+	while (true) {
+		pthread_mutex_lock(&stream->worker_mutex);
+		while (stream->work_generation == generation) {
+			pthread_cond_wait(&stream->work_cond, &stream->worker_mutex);
+		}
+		generation = stream->work_generation;
+		const int mode = stream->work_mode;
+		pthread_mutex_unlock(&stream->worker_mutex);
+
+		if (mode == WORK_QUIT) {
+			return NULL;
+		}
+
+		stream->process_worker_blocks(param->worker, mode == WORK_COMPRESS);
+
+		pthread_mutex_lock(&stream->worker_mutex);
+		if (--stream->workers_busy == 0) {
+			pthread_cond_signal(&stream->done_cond);
+		}
+		pthread_mutex_unlock(&stream->worker_mutex);
+	}
+}
+
+
+void zlib_file_rdwr_stream_t::start_workers()
+{
+	pthread_mutex_init(&worker_mutex, NULL);
+	pthread_cond_init(&work_cond, NULL);
+	pthread_cond_init(&done_cond, NULL);
+	work_generation = 0;
+	workers_busy = 0;
+	work_mode = WORK_QUIT;
+
+	// the calling thread does its share, so one block per batch needs no helper
+	const uint32 helper_count = blocks.get_count() - 1;
+	worker_params = new worker_param_t[helper_count];
+	for (uint32 i = 0; i < helper_count; i++) {
+		worker_params[i].stream = this;
+		worker_params[i].worker = i + 1;
+
+		pthread_t thread;
+		if (pthread_create(&thread, NULL, &worker_thread, &worker_params[i]) != 0) {
+			// the blocks are split between the threads there are
+			break;
+		}
+		workers.append(thread);
+	}
+}
+
+
+void zlib_file_rdwr_stream_t::stop_workers()
+{
+	pthread_mutex_lock(&worker_mutex);
+	work_mode = WORK_QUIT;
+	work_generation++;
+	pthread_cond_broadcast(&work_cond);
+	pthread_mutex_unlock(&worker_mutex);
+
+	for(pthread_t thread : workers) {
+		pthread_join(thread, NULL);
+	}
+	workers.clear();
+	delete [] worker_params;
+	worker_params = NULL;
+
+	pthread_cond_destroy(&done_cond);
+	pthread_cond_destroy(&work_cond);
+	pthread_mutex_destroy(&worker_mutex);
+}
+#endif
 
 
 zlib_file_rdwr_stream_t::zlib_file_rdwr_stream_t(const std::string &filename, bool writing, int compression) :
-	rdwr_stream_t(writing)
+	rdwr_stream_t(writing),
+	gzfp(NULL),
+	fp(NULL),
+	compression(clamp( compression, 1, 9 )),
+	curr_block(0),
+	curr_pos(0)
+#ifdef MULTI_THREAD
+	, worker_params(NULL)
+#endif
 {
 	if (is_writing()) {
-		compression = clamp( compression, 1, 9 );
-		char compr[4] = { 'w', 'b', (char)('0' + compression), 0 };
-		gzfp = dr_gzopen(filename.c_str(), compr);
+		fp = dr_fopen(filename.c_str(), "wb");
 	}
 	else {
-		gzfp = dr_gzopen(filename.c_str(), "rb");
+		fp = dr_fopen(filename.c_str(), "rb");
+		if (fp) {
+			// block file?
+			char header[ZLIB_BLOCK_HEADER_SIZE];
+			if (fread(header, 1, ZLIB_BLOCK_HEADER_SIZE, fp) != ZLIB_BLOCK_HEADER_SIZE  ||  memcmp(header, zlib_block_header, sizeof(zlib_block_header)) != 0) {
+				// no, let zlib read it
+				fclose(fp);
+				fp = NULL;
+				gzfp = dr_gzopen(filename.c_str(), "rb");
+				if (gzfp) {
+					gzbuffer(gzfp, 65536);
+				}
+			}
+			else {
+				fseek(fp, 0, SEEK_SET);
+			}
+		}
 	}
-	gzbuffer(gzfp, 65536);
+
+	if (!fp  &&  !gzfp) {
+		status = STATUS_ERR_NOT_EXISTING;
+		return;
+	}
+
+	if (fp) {
+		// one block per thread in each batch
+		const uint32 batch_size = max(1, env_t::num_threads);
+		for (uint32 i = 0; i < batch_size; i++) {
+			blocks.append(block_t());
+			blocks.back().data = new char[ZLIB_BLOCK_SIZE];
+		}
+		curr_block = is_writing() ? 0 : batch_size; // when reading, the first batch is loaded on the first read
+
+#ifdef MULTI_THREAD
+		start_workers();
+#endif
+	}
+
 	status = STATUS_OK;
 }
 
 
 zlib_file_rdwr_stream_t::~zlib_file_rdwr_stream_t()
 {
-	if (is_writing()) {
-		gzflush(gzfp, Z_FINISH);
+	if (gzfp) {
+		gzclose(gzfp);
+	}
+
+	if (fp) {
+		finish();
 	}
 
-	gzclose(gzfp);
+#ifdef MULTI_THREAD
+	if (!blocks.empty()) {
+		stop_workers();
+	}
+#endif
+
+	free_blocks();
+}
+
+
+void zlib_file_rdwr_stream_t::finish()
+{
+	if (!fp) {
+		return;
+	}
+
+	if (is_writing() && status == STATUS_OK) {
+		// the last batch is only compressed now
+		write_blocks();
+	}
+
+	if (fclose(fp) != 0 && is_writing() && status == STATUS_OK) {
+		dbg->error("zlib_file_rdwr_stream_t::finish", "Could not close file");
+		status = STATUS_ERR_FULL;
+	}
+	fp = NULL;
+}
+
+
+void zlib_file_rdwr_stream_t::free_blocks()
+{
+	for(block_t &block : blocks) {
+		delete [] block.data;
+		delete [] block.zdata;
+	}
+	blocks.clear();
+}
+
+
+void zlib_file_rdwr_stream_t::process_worker_blocks(uint32 worker, bool compress)
+{
+#ifdef MULTI_THREAD
+	const uint32 thread_count = workers.get_count() + 1;
+#else
+	const uint32 thread_count = 1;
+#endif
+	for (uint32 i = worker; i < blocks.get_count(); i += thread_count) {
+		block_t &block = blocks[i];
+		if (block.len == 0) {
+			continue;
+		}
+		if (compress) {
+			compress_block(block, compression);
+		}
+		else {
+			decompress_block(block);
+		}
+	}
+}
+
+
+void zlib_file_rdwr_stream_t::process_blocks(bool compress)
+{
+#ifdef MULTI_THREAD
+	if (!workers.empty()) {
+		// hand the batch to the waiting helper threads
+		pthread_mutex_lock(&worker_mutex);
+		work_mode = compress ? WORK_COMPRESS : WORK_DECOMPRESS;
+		workers_busy = workers.get_count();
+		work_generation++;
+		pthread_cond_broadcast(&work_cond);
+		pthread_mutex_unlock(&worker_mutex);
+
+		process_worker_blocks(0, compress);
+
+		pthread_mutex_lock(&worker_mutex);
+		while (workers_busy > 0) {
+			pthread_cond_wait(&done_cond, &worker_mutex);
+		}
+		pthread_mutex_unlock(&worker_mutex);
+		return;
+	}
+#endif
+	process_worker_blocks(0, compress);
+}
+
+
+bool zlib_file_rdwr_stream_t::write_blocks()
+{
+	process_blocks(true);
+
+	for(block_t &block : blocks) {
+		if (block.len == 0) {
+			break;
+		}
+
+		if (!block.ok) {
+			dbg->error("zlib_file_rdwr_stream_t::write_blocks", "Error during compression");
+			status = STATUS_ERR_CORRUPT;
+			return false;
+		}
+
+		if (fwrite(block.zdata, 1, block.zlen, fp) != block.zlen) {
+			status = STATUS_ERR_FULL;
+			return false;
+		}
+
+		block.len = 0;
+		delete [] block.zdata;
+		block.zdata = NULL;
+	}
+
+	return true;
+}
+
+
+bool zlib_file_rdwr_stream_t::read_blocks()
+{
+	// read the members of the next batch
+	for(block_t &block : blocks) {
+		block.len = 0;
+		delete [] block.zdata;
+		block.zdata = NULL;
+
+		if (status != STATUS_OK) {
+			continue;
+		}
+
+		char header[ZLIB_BLOCK_HEADER_SIZE];
+		const size_t header_read = fread(header, 1, ZLIB_BLOCK_HEADER_SIZE, fp);
+		if (header_read == 0  &&  feof(fp)) {
+			status = STATUS_EOF;
+			continue;
+		}
+
+		const size_t zlen = get_uint32(header + sizeof(zlib_block_header));
+		if (header_read != ZLIB_BLOCK_HEADER_SIZE  ||  memcmp(header, zlib_block_header, sizeof(zlib_block_header)) != 0  ||
+			zlen < ZLIB_BLOCK_HEADER_SIZE + ZLIB_BLOCK_TRAILER_SIZE  ||  zlen > ZLIB_BLOCK_HEADER_SIZE + 2 * ZLIB_BLOCK_SIZE) {
+			dbg->error("zlib_file_rdwr_stream_t::read_blocks", "Invalid block header");
+			status = STATUS_ERR_CORRUPT;
+			continue;
+		}
+
+		block.zdata = new char[zlen];
+		block.zlen = zlen;
+		memcpy(block.zdata, header, ZLIB_BLOCK_HEADER_SIZE);
+		if (fread(block.zdata + ZLIB_BLOCK_HEADER_SIZE, 1, zlen - ZLIB_BLOCK_HEADER_SIZE, fp) != zlen - ZLIB_BLOCK_HEADER_SIZE) {
+			dbg->error("zlib_file_rdwr_stream_t::read_blocks", "File too short");
+			status = STATUS_ERR_CORRUPT;
+			continue;
+		}
+
+		block.len = get_uint32(block.zdata + zlen - 4);
+		if (block.len > ZLIB_BLOCK_SIZE) {
+			dbg->error("zlib_file_rdwr_stream_t::read_blocks", "Invalid block size");
+			block.len = 0;
+			status = STATUS_ERR_CORRUPT;
+		}
+	}
+
+	if (status == STATUS_ERR_CORRUPT) {
+		return false;
+	}
+
+	process_blocks(false);
+
+	for(block_t &block : blocks) {
+		if (block.len == 0) {
+			break;
+		}
+		if (!block.ok) {
+			dbg->error("zlib_file_rdwr_stream_t::read_blocks", "Error during decompression");
+			status = STATUS_ERR_CORRUPT;
+			return false;
+		}
+	}
+
+	curr_block = 0;
+	curr_pos = 0;
+	return blocks[0].len > 0;
 }
 
 
@@ -42,6 +445,33 @@ size_t zlib_file_rdwr_stream_t::read(void *buf, size_t len)
 {
 	assert(!is_writing());
 
+	if (fp) {
+		size_t bytes_read = 0;
+		while (bytes_read < len) {
+			if (curr_block < blocks.get_count()  &&  curr_pos < blocks[curr_block].len) {
+				const size_t n = std::min(len - bytes_read, blocks[curr_block].len - curr_pos);
+				memcpy((char *)buf + bytes_read, blocks[curr_block].data + curr_pos, n);
+				bytes_read += n;
+				curr_pos += n;
+			}
+			else if (curr_block + 1 < blocks.get_count()  &&  blocks[curr_block + 1].len > 0) {
+				curr_block++;
+				curr_pos = 0;
+			}
+			else if (status != STATUS_OK  ||  !read_blocks()) {
+				break;
+			}
+		}
+
+		if (bytes_read == len) {
+			status = STATUS_OK;
+		}
+		else if (status == STATUS_OK) {
+			status = STATUS_EOF;
+		}
+		return status == STATUS_ERR_CORRUPT ? 0 : bytes_read;
+	}
+
 	const int bytes_read = gzread(gzfp, buf, len);
 
 	if (bytes_read >= 0 && (size_t)bytes_read == len) {
@@ -70,16 +500,27 @@ size_t zlib_file_rdwr_stream_t::read(void *buf, size_t len)
 size_t zlib_file_rdwr_stream_t::write(const void *buf, size_t len)
 {
 	assert(is_writing());
-	const int bytes_written = gzwrite(gzfp, const_cast<void *>(buf), len);
 
-	if (bytes_written == 0) {
-		status = STATUS_ERR_FULL;
-		return 0;
-	}
-	else {
-		status = STATUS_OK;
-		return bytes_written;
-	}
-}
+	size_t bytes_written = 0;
+	while (bytes_written < len) {
+		block_t &block = blocks[curr_block];
+		const size_t n = std::min(len - bytes_written, (size_t)ZLIB_BLOCK_SIZE - block.len);
+		memcpy(block.data + block.len, (const char *)buf + bytes_written, n);
+		block.len += n;
+		bytes_written += n;
 
+		if (block.len == ZLIB_BLOCK_SIZE) {
+			curr_block++;
+			if (curr_block == blocks.get_count()) {
+				// batch full
+				curr_block = 0;
+				if (!write_blocks()) {
+					return 0;
+				}
+			}
+		}
+	}
 
+	status = STATUS_OK;
+	return bytes_written;
+}
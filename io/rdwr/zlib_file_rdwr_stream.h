@@ -8,11 +8,25 @@
 
 
 #include "rdwr_stream.h"
+#include "../../tpl/vector_tpl.h"
 
+#include <cstdio>
 #include <zlib.h>
 
+#ifdef MULTI_THREAD
+#include "../../utils/simthread.h"
+#endif
+
 
-/// Reads/writes data from/to a zlib/gzip (deflate) compressed file.
+/**
+ * Reads/writes data from/to a zlib/gzip (deflate) compressed file.
+ *
+ * Files are written as a series of gzip members of up to 1 MiB of data each,
+ * compressed independently on all threads. Each member carries its compressed
+ * size in an extra header field, so such files can be split into members without
+ * decompressing and read on all threads, too. Since concatenated gzip members
+ * are still one valid gzip file, any other gzip file is read by zlib itself.
+ */
 class zlib_file_rdwr_stream_t : public rdwr_stream_t
 {
 public:
@@ -26,8 +40,71 @@ public:
 	/// @copydoc rdwr_stream_t::write
 	size_t write(const void *buf, size_t len) OVERRIDE;
 
+	/// @copydoc rdwr_stream_t::finish
+	void finish() OVERRIDE;
+
+public:
+	/// One gzip member of a block file.
+	struct block_t
+	{
+		char *data;   ///< uncompressed data
+		size_t len;
+		char *zdata;  ///< the complete gzip member
+		size_t zlen;
+		bool ok;
+
+		block_t() : data(NULL), len(0), zdata(NULL), zlen(0), ok(false) {}
+	};
+
 private:
-	gzFile gzfp;
+	/// compress or decompress all blocks of the batch, on as many threads as possible
+	void process_blocks(bool compress);
+
+	/// compress the batch and write it to the file
+	bool write_blocks();
+
+	/// read and decompress the next batch from the file
+	bool read_blocks();
+
+	void free_blocks();
+
+	/// compress or decompress every block of the batch assigned to @p worker
+	void process_worker_blocks(uint32 worker, bool compress);
+
+#ifdef MULTI_THREAD
+	void start_workers();
+	void stop_workers();
+
+	struct worker_param_t
+	{
+		zlib_file_rdwr_stream_t *stream;
+		uint32 worker; ///< 1 for the first helper thread; the calling thread is worker 0
+	};
+
+	static void *worker_thread(void *ptr);
+#endif
+
+private:
+	gzFile gzfp; ///< for gzip files without block sizes
+
+	FILE *fp;    ///< for block files
+	int compression;
+
+	vector_tpl<block_t> blocks; ///< current batch
+	uint32 curr_block;          ///< block currently filled or read
+	size_t curr_pos;            ///< position therein
+
+#ifdef MULTI_THREAD
+	/// Helper threads, which live as long as the stream and wait for each batch
+	vector_tpl<pthread_t> workers;
+	worker_param_t *worker_params;
+	pthread_mutex_t worker_mutex;
+	pthread_cond_t work_cond;   ///< a new batch is ready, or the workers should quit
+	pthread_cond_t done_cond;   ///< all workers have finished the batch
+	uint32 work_generation;     ///< counts the batches handed to the workers
+	uint32 workers_busy;
+	int work_mode;              ///< one of the WORK_* values of the .cc file
+#endif
 };
 
 
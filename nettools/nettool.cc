@@ -444,6 +444,10 @@ void usage()
 		"      force-sync\n"
 		"        Force server to send sync command in order to save & reload the game\n"
 		"\n"
+		"      step-profile <mode>\n"
+		"        Show the time spent in each part of the last 256 world steps\n"
+		"        mode 0: as table, 1: as CSV, 2: as table and reset the statistics\n"
+		"\n"
 		"    Return codes:\n"
 		"      0 .. success\n"
 		"      1 .. server not reachable\n"
@@ -548,7 +552,8 @@ int main(int argc, char* argv[]) {
 		{"info-company",   true,  nwc_service_t::SRVC_GET_COMPANY_INFO, 1, &simple_gettext_command},
 		{"unlock-company", true,  nwc_service_t::SRVC_UNLOCK_COMPANY,   1, &simple_command},
 		{"remove-company", true,  nwc_service_t::SRVC_REMOVE_COMPANY,   1, &simple_command},
-		{"lock-company",   true,  nwc_service_t::SRVC_LOCK_COMPANY,     2, &lock_company}
+		{"lock-company",   true,  nwc_service_t::SRVC_LOCK_COMPANY,     2, &lock_company},
+		{"step-profile",   true,  nwc_service_t::SRVC_GET_STEP_PROFILE, 1, &simple_gettext_command}
 	};
 	int numcommands = lengthof(commands);
 
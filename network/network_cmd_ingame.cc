@@ -25,6 +25,7 @@
 #include "../utils/simrandom.h"
 #include "../utils/cbuffer_t.h"
 #include "../utils/csv.h"
+#include "../utils/step_profiler.h"
 #include "../display/viewport.h"
 
 
@@ -722,9 +723,17 @@ void nwc_sync_t::do_command(karte_t *welt)
 		bool old_restore_UI = env_t::restore_UI;
 		env_t::restore_UI = true;
 
-		welt->save( fn, true, SERVER_SAVEGAME_VER_NR, EXTENDED_VER_NR, EXTENDED_REVISION_NR, false );
+		// the game is only reloaded here, so keep it in memory instead of compressing it into a file
+		memory_rdwr_stream_t::buffer_t snapshot;
 		uint32 old_sync_steps = welt->get_sync_steps();
-		welt->load( fn );
+		if(  welt->save( snapshot, SERVER_SAVEGAME_VER_NR, EXTENDED_VER_NR )  ) {
+			welt->load( fn, &snapshot );
+		}
+		else {
+			dbg->warning("nwc_sync_t::do_command", "Could not save game to memory, using %s", fn);
+			welt->save( fn, true, SERVER_SAVEGAME_VER_NR, EXTENDED_VER_NR, EXTENDED_REVISION_NR, false );
+			welt->load( fn );
+		}
 		env_t::restore_UI = old_restore_UI;
 
 		// pause clients, restore steps
@@ -1608,6 +1617,26 @@ bool nwc_service_t::execute(karte_t *welt)
 			break;
 		}
 
+		case SRVC_GET_STEP_PROFILE: {
+			// number: 0 = table, 1 = CSV, 2 = table and reset the statistics
+			cbuffer_t buf;
+			if (number == 1) {
+				step_profiler_t::print_csv(buf);
+			}
+			else {
+				step_profiler_t::print(buf);
+			}
+			if (number == 2) {
+				step_profiler_t::reset();
+			}
+
+			nwc_service_t nws;
+			nws.flag = flag;
+			nws.text = strdup(buf);
+			nws.send(packet->get_sender());
+			break;
+		}
+
 		default: ;
 	}
 	return true; // to delete
@@ -43,6 +43,12 @@ bool path_explorer_t::must_refresh_on_loading;
 #ifdef MULTI_THREAD
 bool thread_local path_explorer_t::allow_path_explorer_on_this_thread = false;
 #endif
+#ifdef MULTI_THREAD_PATH_EXPLORER
+uint32 path_explorer_t::explore_thread_count = 1;
+path_explorer_t::compartment_t *path_explorer_t::exploring_compartment = NULL;
+uint16 path_explorer_t::exploring_via = 0;
+uint32 path_explorer_t::exploring_origin_cluster_end = 0;
+#endif
 
 void path_explorer_t::initialise(karte_t *welt)
 {
@@ -312,6 +318,27 @@ void path_explorer_t::next_compartment()
 }
 
 
+#ifdef MULTI_THREAD_PATH_EXPLORER
+void path_explorer_t::explore_transfer_in_parallel(compartment_t *compartment, const uint16 via, const uint32 origin_cluster_end)
+{
+	exploring_compartment = compartment;
+	exploring_via = via;
+	exploring_origin_cluster_end = origin_cluster_end;
+	world->step_path_explorer_workers();
+	exploring_compartment = NULL;
+}
+
+
+void path_explorer_t::explore_transfer_worker(const uint32 thread_number)
+{
+	if (exploring_compartment)
+	{
+		exploring_compartment->explore_transfer(exploring_via, exploring_origin_cluster_end, thread_number, explore_thread_count);
+	}
+}
+#endif
+
+
 void path_explorer_t::full_instant_refresh()
 {
 #ifdef MULTI_THREAD
@@ -448,7 +475,8 @@ const char *const path_explorer_t::compartment_t::phase_name[] =
 	"filter",
 	"matrix",
 	"explore",
-	"reroute"
+	"reroute",
+	"update"
 };
 
 path_explorer_t::compartment_t::connexion_list_entry_t path_explorer_t::compartment_t::connexion_list[65536];
@@ -495,6 +523,13 @@ path_explorer_t::compartment_t::compartment_t()
 	transfer_list = NULL;
 	transfer_count = 0;
 
+	update_stage = update_stage_analyse;
+	update_connexion_index = 0;
+	transfer_flags = NULL;
+	row_affected = NULL;
+	search_settled = NULL;
+	incremental_refresh_count = 0;
+
 	catg = 255;
 	g_class = 255;
 	catg_name = NULL;
@@ -529,11 +564,7 @@ path_explorer_t::compartment_t::~compartment_t()
 {
 	if (finished_matrix)
 	{
-		for (uint16 i = 0; i < finished_halt_count; ++i)
-		{
-			delete[] finished_matrix[i];
-		}
-		delete[] finished_matrix;
+		finished_matrix->release();
 	}
 	if (finished_halt_index_map)
 	{
@@ -586,6 +617,19 @@ path_explorer_t::compartment_t::~compartment_t()
 		delete[] transfer_list;
 	}
 
+	if (transfer_flags)
+	{
+		delete[] transfer_flags;
+	}
+	if (row_affected)
+	{
+		delete[] row_affected;
+	}
+	if (search_settled)
+	{
+		delete[] search_settled;
+	}
+
 	if (inbound_connections)
 	{
 		delete inbound_connections;
@@ -611,11 +655,7 @@ void path_explorer_t::compartment_t::reset(const bool reset_finished_set)
 	{
 		if (finished_matrix)
 		{
-			for (uint16 i = 0; i < finished_halt_count; ++i)
-			{
-				delete[] finished_matrix[i];
-			}
-			delete[] finished_matrix;
+			finished_matrix->release();
 			finished_matrix = NULL;
 		}
 		if (finished_halt_index_map)
@@ -624,7 +664,12 @@ void path_explorer_t::compartment_t::reset(const bool reset_finished_set)
 			finished_halt_index_map = NULL;
 		}
 		finished_halt_count = 0;
+		finished_edges.clear();
+		finished_transfers.clear();
+		incremental_refresh_count = 0;
 	}
+	working_edges.clear();
+	clear_incremental_update();
 
 
 	if (working_matrix)
@@ -1548,24 +1593,48 @@ void path_explorer_t::compartment_t::step()
 				statistic_duration = 0;
 				statistic_iteration = 0;
 
-				// delete immediately after use
-				if (working_halt_list)
-				{
-					delete[] working_halt_list;
-					working_halt_list = NULL;
-				}
-				if (transport_index_map)
+				// A lower class with identical connexions already has the paths; otherwise, if only
+				// a few connexions have changed since the last refresh, patch the previous paths
+				// instead of exploring all paths again
+				collect_working_edges();
+				path_matrix_t *const shared_paths = find_identical_class_paths();
+				const bool update_incrementally = !shared_paths && prepare_incremental_update();
+
+				// delete immediately after use, unless still needed for the incremental update
+				if (!update_incrementally)
 				{
-					delete[] transport_index_map;
-					transport_index_map = NULL;
+					if (working_halt_list)
+					{
+						delete[] working_halt_list;
+						working_halt_list = NULL;
+					}
+					if (transport_index_map)
+					{
+						delete[] transport_index_map;
+						transport_index_map = NULL;
+					}
 				}
 
-				current_phase = phase_explore_paths;	// proceed to the next phase
 				phase_counter = 0;	// reset counter
 
 #ifdef DEBUG_COMPARTMENT_STEP
 				printf("\tTransfer Count :  %lu \n", transfer_count);
 #endif
+
+				if (shared_paths)
+				{
+					publish_working_paths(shared_paths);
+					paths_available = true;
+					current_phase = phase_reroute_goods;	// skip path exploration
+				}
+				else if (update_incrementally)
+				{
+					current_phase = phase_update_paths;	// patch the previous paths instead of exploring
+				}
+				else
+				{
+					current_phase = phase_explore_paths;	// proceed to the next phase
+				}
 			}
 
 			iterations = 0;	// reset iteration counter
@@ -1585,13 +1654,10 @@ void path_explorer_t::compartment_t::step()
 
 			printf("\t\tCurrent Step : %lu \n", step_count);
 #endif
-			// temporary variables
-			uint32 combined_time;
-			uint32 target_member_index;
 			uint64 iterations_processed = 0;
 
 			// initialize only when not resuming
-			if ( via_index == 0 && origin_cluster_index == 0 && target_cluster_index == 0 && origin_member_index == 0 )
+			if ( via_index == 0 && process_next_transfer )
 			{
 				// build data structures for inbound/outbound connections to/from transfer halts
 				inbound_connections = new connection_t(64u, working_halt_count);
@@ -1625,82 +1691,59 @@ void path_explorer_t::compartment_t::step()
 					total_iterations += (uint32)working_halt_count + ( inbound_connections->get_total_member_count() << 1 );
 				}
 
-				// for each origin cluster
-				while ( origin_cluster_index < inbound_connections->get_cluster_count() )
+				// Take whole origin clusters until the iteration limit is reached. The step boundaries
+				// depend only on the connections, so they are the same for any number of threads.
+				const uint32 origin_cluster_count = inbound_connections->get_cluster_count();
+				uint32 origin_cluster_end = origin_cluster_index;
+				uint64 cluster_iterations = 0;
+				while ( origin_cluster_end < origin_cluster_count )
 				{
-					const connection_t::connection_cluster_t &origin_cluster = (*inbound_connections)[origin_cluster_index];
-					const uint16 inbound_transport = origin_cluster.transport;
-					const vector_tpl<uint16> &origin_halt_list = origin_cluster.connected_halts;
-
-					// for each target cluster
-					while ( target_cluster_index < outbound_connections->get_cluster_count() )
+					cluster_iterations += count_cluster_iterations(origin_cluster_end);
+					++origin_cluster_end;
+					if ( use_limits && iterations_processed + cluster_iterations >= limit_explore_paths )
 					{
-						const connection_t::connection_cluster_t &target_cluster = (*outbound_connections)[target_cluster_index];
-						const uint16 outbound_transport = target_cluster.transport;
-						if ( inbound_transport == outbound_transport && inbound_transport != 0u )
-						{
-							++target_cluster_index;
-							continue;
-						}
-						const vector_tpl<uint16> &target_halt_list = target_cluster.connected_halts;
-
-						// for each origin cluster member
-						while ( origin_member_index < origin_halt_list.get_count() )
-						{
-							const uint16 origin = origin_halt_list[origin_member_index];
-
-							// for each target cluster member
-							for ( target_member_index = 0; target_member_index < target_halt_list.get_count(); ++target_member_index )
-							{
-								const uint16 target = target_halt_list[target_member_index];
-
-								if ( ( combined_time = working_matrix[origin][via].aggregate_time
-													 + working_matrix[via][target].aggregate_time )
-											< working_matrix[origin][target].aggregate_time			   )
-								{
-									working_matrix[origin][target].aggregate_time = combined_time;
-									working_matrix[origin][target].next_transfer = working_matrix[origin][via].next_transfer;
-									transport_matrix[origin][target].first_transport = transport_matrix[origin][via].first_transport;
-									transport_matrix[origin][target].last_transport = transport_matrix[via][target].last_transport;
-								}
-							}	// loop : target cluster member
-
-							++origin_member_index;
-
-							// iteration control
-							iterations_processed += target_halt_list.get_count();
-							total_iterations += target_halt_list.get_count();
-							if ( use_limits && iterations_processed >= limit_explore_paths )
-							{
-								goto loop_termination;
-							}
-
-						}	// loop : origin cluster member
-
-						origin_member_index = 0;
-
-						++target_cluster_index;
-
-					}	// loop : target cluster
+						break;
+					}
+				}
 
-					target_cluster_index = 0;
+				// The whole of each origin cluster is explored. Older saves may have stopped in the
+				// middle of one; relaxing the same paths again is harmless.
+				target_cluster_index = 0;
+				origin_member_index = 0;
 
-					++origin_cluster_index;
+#ifdef MULTI_THREAD_PATH_EXPLORER
+				if ( explore_thread_count > 1 )
+				{
+					explore_transfer_in_parallel(this, via, origin_cluster_end);
+				}
+				else
+#endif
+				{
+					explore_transfer(via, origin_cluster_end, 0, 1);
+				}
 
-				}	// loop : origin cluster
+				// iteration control
+				iterations_processed += cluster_iterations;
+				total_iterations += (uint32)cluster_iterations;
 
-				origin_cluster_index = 0;
+				origin_cluster_index = origin_cluster_end;
+				if ( origin_cluster_index == origin_cluster_count )
+				{
+					// clear the inbound/outbound connections
+					inbound_connections->reset();
+					outbound_connections->reset();
+					process_next_transfer = true;
 
-				// clear the inbound/outbound connections
-				inbound_connections->reset();
-				outbound_connections->reset();
-				process_next_transfer = true;
+					origin_cluster_index = 0;
+					++via_index;
+				}
 
-				++via_index;
+				if ( use_limits && iterations_processed >= limit_explore_paths )
+				{
+					break;
+				}
 			}	// loop : transfer
 
-		loop_termination :
-
 			diff = dr_time() - start;	// stop timing
 
 			// iterations statistics collection
@@ -1748,75 +1791,154 @@ void path_explorer_t::compartment_t::step()
 				statistic_iteration = 0;
 
 
-				// path search completed -> delete old path info
-				if (finished_matrix)
+				publish_working_paths();
+				incremental_refresh_count = 0;
+
+				// Debug paths : to execute, working_halt_list should not be deleted in the previous phase
+				// enumerate_all_paths(finished_matrix, working_halt_list, finished_halt_index_map, finished_halt_count);
+
+				current_phase = phase_reroute_goods;	// proceed to the next phase
+
+				// reset counters
+				via_index = 0;
+				origin_cluster_index = 0;
+				target_cluster_index = 0;
+				origin_member_index = 0;
+
+				paths_available = true;
+			}
+
+			iterations = 0;	// reset iteration counter // desync debug
+
+			return;
+		}
+
+		/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+		// Phase 7 : Instead of phase 5, patch the previous paths with the changes in direct connexions
+		/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+		case phase_update_paths :
+		{
+#ifdef DEBUG_COMPARTMENT_STEP
+			++step_count;
+
+			printf("\t\tCurrent Step : %lu \n", step_count);
+
+			start = dr_time();	// start timing
+#endif
+			// the update is given up once it costs as much as exploring all paths anew
+			const uint32 change_limit = transfer_count / 2u;
+			uint64 iterations_processed = 0;
+			bool update_completed = false;
+			bool update_abandoned = false;
+			uint32 *const chain_values = ( update_stage <= update_stage_copy ? new uint32[working_halt_count] : NULL );
+
+			while ( !use_limits || iterations_processed < limit_explore_paths )
+			{
+				if ( update_stage == update_stage_analyse )
 				{
-					for (uint16 i = 0; i < finished_halt_count; ++i)
+					// find the origins whose goods would travel over a broken connexion
+					if ( phase_counter < working_halt_count )
 					{
-						delete[] finished_matrix[i];
+						iterations_processed += resolve_finished_chains(phase_counter, chain_values, true);
+						++phase_counter;
+						if ( affected_rows.get_count() + faster_connexions.get_count() > change_limit )
+						{
+							update_abandoned = true;
+							break;
+						}
+						continue;
 					}
-					delete[] finished_matrix;
-					finished_matrix = NULL;
+					update_stage = update_stage_copy;
+					phase_counter = 0;
 				}
-				if (finished_halt_index_map)
+
+				if ( update_stage == update_stage_copy )
 				{
-					delete[] finished_halt_index_map;
-					finished_halt_index_map = NULL;
+					// start from the previous paths
+					if ( phase_counter < working_halt_count )
+					{
+						iterations_processed += copy_finished_column(phase_counter, chain_values);
+						++phase_counter;
+						continue;
+					}
+					update_stage = update_stage_search;
+					phase_counter = 0;
 				}
 
-				// transfer working to finished
-				finished_matrix = working_matrix;
-				working_matrix = NULL;
-				finished_halt_index_map = working_halt_index_map;
-				working_halt_index_map = NULL;
-				finished_halt_count = working_halt_count;
-				// working_halt_count is reset below after deleting transport matrix
-
-				// path search completed -> delete auxilliary data structures
-				if (transport_matrix)
+				if ( update_stage == update_stage_search )
 				{
-					for (uint16 i = 0; i < working_halt_count; ++i)
+					// origins which may have lost their best paths are searched from scratch
+					if ( phase_counter < affected_rows.get_count() )
 					{
-						delete[] transport_matrix[i];
+						iterations_processed += search_paths_from(affected_rows[phase_counter]);
+						++phase_counter;
+						continue;
 					}
-					delete[] transport_matrix;
-					transport_matrix = NULL;
+					update_stage = update_stage_relax;
+					update_connexion_index = 0;
+					phase_counter = 0;
 				}
-				working_halt_count = 0;
-				if (transfer_list)
+
+				// a faster connexion can only shorten paths : relax the paths of every origin through it
+				if ( update_connexion_index < faster_connexions.get_count() )
 				{
-					delete[] transfer_list;
-					transfer_list = NULL;
+					iterations_processed += relax_faster_connexion(faster_connexions[update_connexion_index], phase_counter);
+					if ( ++phase_counter == working_halt_count )
+					{
+						phase_counter = 0;
+						++update_connexion_index;
+					}
+					continue;
 				}
-				transfer_count = 0;
 
-				if (inbound_connections)
+				update_completed = true;
+				break;
+			}
+
+			if (chain_values)
+			{
+				delete[] chain_values;
+			}
+			total_iterations += (uint32)iterations_processed;
+
+#ifdef DEBUG_COMPARTMENT_STEP
+			diff = dr_time() - start;	// stop timing
+			printf("\t\t\tIncremental update -> %lu iterations takes :  %lu ms \n", static_cast<unsigned long>(iterations_processed), diff);
+#endif
+
+			if (update_completed || update_abandoned)
+			{
+				clear_incremental_update();
+
+				// delete immediately after use
+				if (working_halt_list)
 				{
-					delete inbound_connections;
-					inbound_connections = NULL;
+					delete[] working_halt_list;
+					working_halt_list = NULL;
 				}
-				if (outbound_connections)
+				if (transport_index_map)
 				{
-					delete outbound_connections;
-					outbound_connections = NULL;
+					delete[] transport_index_map;
+					transport_index_map = NULL;
 				}
-				process_next_transfer = true;
 
-				// Debug paths : to execute, working_halt_list should not be deleted in the previous phase
-				// enumerate_all_paths(finished_matrix, working_halt_list, finished_halt_index_map, finished_halt_count);
-
-				current_phase = phase_reroute_goods;	// proceed to the next phase
-
-				// reset counters
-				via_index = 0;
-				origin_cluster_index = 0;
-				target_cluster_index = 0;
-				origin_member_index = 0;
+				phase_counter = 0;	// reset counter
 
-				paths_available = true;
+				if (update_completed)
+				{
+					++incremental_refresh_count;
+					publish_working_paths();
+					paths_available = true;
+					current_phase = phase_reroute_goods;	// proceed to the next phase
+				}
+				else
+				{
+					// the working matrix is still untouched
+					current_phase = phase_explore_paths;
+				}
 			}
 
-			iterations = 0;	// reset iteration counter // desync debug
+			iterations = 0;	// reset iteration counter
 
 			return;
 		}
@@ -1943,7 +2065,7 @@ void path_explorer_t::compartment_t::step()
 }
 
 
-void path_explorer_t::compartment_t::enumerate_all_paths(const path_element_t *const *const matrix, const halthandle_t *const halt_list,
+void path_explorer_t::compartment_t::enumerate_all_paths(const path_matrix_t *const matrix, const halthandle_t *const halt_list,
 														 const uint16 *const halt_map, const uint16 halt_count)
 {
 	// Debugging code : Enumerate all paths for validation
@@ -1958,9 +2080,9 @@ void path_explorer_t::compartment_t::enumerate_all_paths(const path_element_t *c
 				// print origin
 				printf("\n\nOrigin :  %s\n", halt_list[x]->get_name());
 
-				transfer_halt = matrix[x][y].next_transfer;
+				transfer_halt = matrix->get_next_transfer(x, y);
 
-				if (matrix[x][y].aggregate_time == UINT32_MAX_VALUE)
+				if (matrix->get_aggregate_time(x, y) == UINT32_MAX_VALUE)
 				{
 					printf("\t\t\t\t******** No Route ********\n");
 				}
@@ -1972,7 +2094,7 @@ void path_explorer_t::compartment_t::enumerate_all_paths(const path_element_t *c
 
 						if ( halt_map[transfer_halt.get_id()] != 65535)
 						{
-							transfer_halt = matrix[ halt_map[transfer_halt.get_id()] ][y].next_transfer;
+							transfer_halt = matrix->get_next_transfer( halt_map[transfer_halt.get_id()], y );
 						}
 						else
 						{
@@ -1990,6 +2112,616 @@ void path_explorer_t::compartment_t::enumerate_all_paths(const path_element_t *c
 }
 
 
+void path_explorer_t::compartment_t::explore_transfer(const uint16 via, const uint32 origin_cluster_end, const uint32 thread_number, const uint32 thread_count)
+{
+	const path_element_t *const via_row = working_matrix[via];
+	const transport_element_t *const via_transport_row = transport_matrix[via];
+
+	// for each origin cluster of this step
+	for ( uint32 oc = origin_cluster_index; oc < origin_cluster_end; ++oc )
+	{
+		const connection_t::connection_cluster_t &origin_cluster = (*inbound_connections)[oc];
+		const uint16 inbound_transport = origin_cluster.transport;
+		const vector_tpl<uint16> &origin_halt_list = origin_cluster.connected_halts;
+
+		// for each target cluster
+		for ( uint32 tc = 0; tc < outbound_connections->get_cluster_count(); ++tc )
+		{
+			const connection_t::connection_cluster_t &target_cluster = (*outbound_connections)[tc];
+			if ( inbound_transport == target_cluster.transport && inbound_transport != 0u )
+			{
+				continue;
+			}
+			const vector_tpl<uint16> &target_halt_list = target_cluster.connected_halts;
+			const uint32 target_count = target_halt_list.get_count();
+
+			// for each origin cluster member of this thread : each origin occurs only once per transfer,
+			// so each thread writes its own rows and reads only the row and column of the transfer
+			for ( uint32 m = thread_number; m < origin_halt_list.get_count(); m += thread_count )
+			{
+				const uint16 origin = origin_halt_list[m];
+				path_element_t *const origin_row = working_matrix[origin];
+				transport_element_t *const origin_transport_row = transport_matrix[origin];
+				const uint32 to_via = origin_row[via].aggregate_time;
+				if ( to_via == UINT32_MAX_VALUE )
+				{
+					continue;
+				}
+
+				// for each target cluster member
+				for ( uint32 t = 0; t < target_count; ++t )
+				{
+					const uint16 target = target_halt_list[t];
+					const uint32 combined_time = to_via + via_row[target].aggregate_time;
+
+					if ( combined_time < origin_row[target].aggregate_time )
+					{
+						origin_row[target].aggregate_time = combined_time;
+						origin_row[target].next_transfer = origin_row[via].next_transfer;
+						origin_transport_row[target].first_transport = origin_transport_row[via].first_transport;
+						origin_transport_row[target].last_transport = via_transport_row[target].last_transport;
+					}
+				}	// loop : target cluster member
+			}	// loop : origin cluster member
+		}	// loop : target cluster
+	}	// loop : origin cluster
+}
+
+
+uint64 path_explorer_t::compartment_t::count_cluster_iterations(const uint32 origin_cluster) const
+{
+	uint64 count = 0;
+	const connection_t::connection_cluster_t &origin_cluster_data = (*inbound_connections)[origin_cluster];
+	for ( uint32 tc = 0; tc < outbound_connections->get_cluster_count(); ++tc )
+	{
+		const connection_t::connection_cluster_t &target_cluster = (*outbound_connections)[tc];
+		if ( origin_cluster_data.transport != target_cluster.transport || origin_cluster_data.transport == 0u )
+		{
+			count += (uint64)origin_cluster_data.connected_halts.get_count() * target_cluster.connected_halts.get_count();
+		}
+	}
+	return count;
+}
+
+
+void path_explorer_t::compartment_t::collect_working_edges()
+{
+	working_edges.clear();
+	working_edges.offsets.resize(working_halt_count + 1);
+
+	// map the transport indices of this refresh back to line and convoy ids
+	vector_tpl<uint32> transport_keys;
+	transport_keys.append(0u);	// walking
+	for (uint32 key = 0; key < 131072; ++key)
+	{
+		const uint16 idx = transport_index_map[key];
+		if ( idx )
+		{
+			while ( transport_keys.get_count() <= idx )
+			{
+				transport_keys.append(0u);
+			}
+			transport_keys[idx] = key;
+		}
+	}
+
+	direct_edge_t edge;
+	for (uint16 i = 0; i < working_halt_count; ++i)
+	{
+		working_edges.offsets.append(working_edges.edges.get_count());
+		for (uint16 j = 0; j < working_halt_count; ++j)
+		{
+			if ( i != j && working_matrix[i][j].aggregate_time != UINT32_MAX_VALUE )
+			{
+				edge.target = j;
+				edge.aggregate_time = working_matrix[i][j].aggregate_time;
+				edge.transport = transport_keys[ transport_matrix[i][j].first_transport ];
+				working_edges.edges.append(edge);
+			}
+		}
+	}
+	working_edges.offsets.append(working_edges.edges.get_count());
+}
+
+
+bool path_explorer_t::compartment_t::has_same_halts_as_finished(const compartment_t &source) const
+{
+	if ( !source.paths_available || !source.finished_matrix || source.finished_edges.empty() || working_halt_count == 0
+		 || working_halt_count != source.finished_halt_count || transfer_count != source.finished_transfers.get_count() )
+	{
+		return false;
+	}
+	for (uint16 i = 0; i < working_halt_count; ++i)
+	{
+		if ( !working_halt_list[i].is_bound() || source.finished_halt_index_map[ working_halt_list[i].get_id() ] != i )
+		{
+			return false;
+		}
+	}
+	for (uint16 i = 0; i < transfer_count; ++i)
+	{
+		if ( transfer_list[i] != source.finished_transfers[i] )
+		{
+			return false;
+		}
+	}
+	return true;
+}
+
+
+path_explorer_t::compartment_t::path_matrix_t *path_explorer_t::compartment_t::find_identical_class_paths() const
+{
+	// classes of a category are refreshed in ascending order, so lower classes hold the most recent paths
+	for (uint8 cl = 0; cl < g_class; ++cl)
+	{
+		const compartment_t &other = goods_compartment[catg][cl];
+		if ( has_same_halts_as_finished(other) && working_edges.is_equal(other.finished_edges) )
+		{
+			return other.finished_matrix;
+		}
+	}
+	return NULL;
+}
+
+
+bool path_explorer_t::compartment_t::prepare_incremental_update()
+{
+	// the previous paths must have been computed over exactly the same halts and transfers
+	if ( !has_same_halts_as_finished(*this) || incremental_refresh_count >= max_incremental_refreshes )
+	{
+		return false;
+	}
+
+	// A full path search costs about as much as relaxing all pairs once per transfer.
+	// Patching costs about the same per faster connexion and per origin to search anew.
+	const uint32 change_limit = transfer_count / 2u;
+
+	clear_incremental_update();
+
+	changed_connexion_t connexion;
+	for (uint16 u = 0; u < working_halt_count; ++u)
+	{
+		connexion.origin = u;
+
+		uint32 o = finished_edges.offsets[u];
+		const uint32 o_end = finished_edges.offsets[u + 1];
+		uint32 w = working_edges.offsets[u];
+		const uint32 w_end = working_edges.offsets[u + 1];
+
+		while ( o < o_end || w < w_end )
+		{
+			if ( o == o_end || ( w < w_end && working_edges.edges[w].target < finished_edges.edges[o].target ) )
+			{
+				// new connexion
+				connexion.edge = working_edges.edges[w++];
+				faster_connexions.append(connexion);
+			}
+			else if ( w == w_end || finished_edges.edges[o].target < working_edges.edges[w].target )
+			{
+				// removed connexion
+				connexion.edge = finished_edges.edges[o++];
+				broken_connexions.append(connexion);
+			}
+			else
+			{
+				const direct_edge_t &previous = finished_edges.edges[o++];
+				const direct_edge_t &current = working_edges.edges[w++];
+				if ( previous.transport != current.transport )
+				{
+					// another transport may both break and open journeys, as those never continue on the same one
+					connexion.edge = previous;
+					broken_connexions.append(connexion);
+					connexion.edge = current;
+					faster_connexions.append(connexion);
+				}
+				else if ( current.aggregate_time < previous.aggregate_time )
+				{
+					connexion.edge = current;
+					faster_connexions.append(connexion);
+				}
+				else if ( current.aggregate_time > previous.aggregate_time )
+				{
+					connexion.edge = previous;
+					broken_connexions.append(connexion);
+				}
+			}
+
+			if ( faster_connexions.get_count() > change_limit )
+			{
+				clear_incremental_update();
+				return false;
+			}
+		}
+	}
+
+#ifdef DEBUG_COMPARTMENT_STEP
+	printf("\tIncremental update : %u faster connexions, %u broken connexions \n", faster_connexions.get_count(), broken_connexions.get_count());
+#endif
+
+	transfer_flags = new bool[working_halt_count]();
+	for (uint16 i = 0; i < transfer_count; ++i)
+	{
+		transfer_flags[ transfer_list[i] ] = true;
+	}
+	row_affected = new bool[working_halt_count]();
+	search_settled = new bool[working_halt_count];
+
+	// without broken connexions, no origin has to be searched anew
+	update_stage = ( broken_connexions.empty() ? update_stage_copy : update_stage_analyse );
+	update_connexion_index = 0;
+	return true;
+}
+
+
+void path_explorer_t::compartment_t::clear_incremental_update()
+{
+	if (transfer_flags)
+	{
+		delete[] transfer_flags;
+		transfer_flags = NULL;
+	}
+	if (row_affected)
+	{
+		delete[] row_affected;
+		row_affected = NULL;
+	}
+	if (search_settled)
+	{
+		delete[] search_settled;
+		search_settled = NULL;
+	}
+	search_heap.clear();
+	affected_rows.clear();
+	faster_connexions.clear();
+	broken_connexions.clear();
+	update_stage = update_stage_analyse;
+	update_connexion_index = 0;
+}
+
+
+const path_explorer_t::compartment_t::direct_edge_t *path_explorer_t::compartment_t::find_working_edge(const uint16 origin, const uint16 target) const
+{
+	uint32 low = working_edges.offsets[origin];
+	uint32 high = working_edges.offsets[origin + 1];
+	while ( low < high )
+	{
+		const uint32 mid = ( low + high ) / 2u;
+		if ( working_edges.edges[mid].target < target )
+		{
+			low = mid + 1;
+		}
+		else
+		{
+			high = mid;
+		}
+	}
+	return ( low < working_edges.offsets[origin + 1] && working_edges.edges[low].target == target ? &working_edges.edges[low] : NULL );
+}
+
+
+bool path_explorer_t::compartment_t::is_broken_connexion(const uint16 origin, const uint16 target) const
+{
+	// broken connexions are collected in order of origin and target
+	uint32 low = 0;
+	uint32 high = broken_connexions.get_count();
+	while ( low < high )
+	{
+		const uint32 mid = ( low + high ) / 2u;
+		const changed_connexion_t &connexion = broken_connexions[mid];
+		if ( connexion.origin < origin || ( connexion.origin == origin && connexion.edge.target < target ) )
+		{
+			low = mid + 1;
+		}
+		else
+		{
+			high = mid;
+		}
+	}
+	return low < broken_connexions.get_count() && broken_connexions[low].origin == origin && broken_connexions[low].edge.target == target;
+}
+
+
+uint16 path_explorer_t::compartment_t::get_finished_next_index(const uint16 origin, const uint16 target) const
+{
+	if ( origin == target || finished_matrix->get_aggregate_time(origin, target) == UINT32_MAX_VALUE )
+	{
+		return 65535;
+	}
+	return finished_halt_index_map[ finished_matrix->get_next_transfer_id(origin, target) ];
+}
+
+
+// Values of the halts while following the next transfers towards a target.
+// A halt visited twice on the same chain ends the chain : goods would go round in circles.
+static const uint32 chain_unresolved = UINT32_MAX_VALUE;
+static const uint32 chain_visiting = UINT32_MAX_VALUE - 1u;
+
+
+uint32 path_explorer_t::compartment_t::resolve_finished_chains(const uint16 target, uint32 *const chain_values, const bool analyse)
+{
+	uint32 iterations_done = 0;
+	vector_tpl<uint16> chain;
+
+	for (uint16 x = 0; x < working_halt_count; ++x)
+	{
+		chain_values[x] = chain_unresolved;
+	}
+
+	for (uint16 x = 0; x < working_halt_count; ++x)
+	{
+		// walk along the next transfers until a halt whose value is known
+		uint16 halt = x;
+		while ( chain_values[halt] == chain_unresolved )
+		{
+			chain_values[halt] = chain_visiting;
+			chain.append(halt);
+			halt = get_finished_next_index(halt, target);
+			if ( halt == 65535 )
+			{
+				break;
+			}
+		}
+
+		// then resolve the halts on the way back
+		while ( !chain.empty() )
+		{
+			const uint16 current = chain.pop_back();
+			const uint16 next = get_finished_next_index(current, target);
+			const uint32 next_value = ( next == 65535 || chain_values[next] >= chain_visiting ? 0u : chain_values[next] );
+			++iterations_done;
+
+			if ( next == 65535 )
+			{
+				chain_values[current] = 0u;
+			}
+			else if ( analyse )
+			{
+				// 1 if the goods from current would travel over a broken connexion
+				chain_values[current] = ( next_value || is_broken_connexion(current, next) ? 1u : 0u );
+				if ( chain_values[current] && !row_affected[current] )
+				{
+					row_affected[current] = true;
+					affected_rows.append(current);
+				}
+			}
+			else
+			{
+				// the last transport of the journey from current; connexions missing from
+				// working_edges are only used by affected origins, which are searched anew
+				const direct_edge_t *const edge = find_working_edge(current, next);
+				const uint16 transport = ( edge ? get_transport_index(*edge) : 0u );
+				chain_values[current] = ( next == target ? transport : next_value );
+				transport_matrix[current][target].first_transport = transport;
+				transport_matrix[current][target].last_transport = (uint16)chain_values[current];
+			}
+		}
+	}
+
+	return iterations_done + working_halt_count;
+}
+
+
+uint32 path_explorer_t::compartment_t::copy_finished_column(const uint16 target, uint32 *const chain_values)
+{
+	for (uint16 x = 0; x < working_halt_count; ++x)
+	{
+		working_matrix[x][target].aggregate_time = finished_matrix->get_aggregate_time(x, target);
+		working_matrix[x][target].next_transfer.set_id( finished_matrix->get_next_transfer_id(x, target) );
+		transport_matrix[x][target] = transport_element_t();
+	}
+	return resolve_finished_chains(target, chain_values, false) + working_halt_count;
+}
+
+
+uint32 path_explorer_t::compartment_t::search_paths_from(const uint16 origin)
+{
+	path_element_t *const row = working_matrix[origin];
+	transport_element_t *const transports = transport_matrix[origin];
+	bool *const settled = search_settled;
+	uint32 iterations_done = working_halt_count;
+
+	for (uint16 j = 0; j < working_halt_count; ++j)
+	{
+		row[j] = path_element_t();
+		transports[j] = transport_element_t();
+		settled[j] = false;
+	}
+	row[origin].aggregate_time = 0;
+
+	search_heap.clear();
+	search_heap.insert( search_node_t(0, origin) );
+
+	while ( !search_heap.empty() )
+	{
+		// the nearest unsettled halt; entries superseded by a shorter time are skipped
+		const search_node_t node = search_heap.pop();
+		const uint16 current = node.get_index();
+		const uint32 current_time = node.get_aggregate_time();
+		++iterations_done;
+		if ( settled[current] || current_time != row[current].aggregate_time )
+		{
+			continue;
+		}
+		settled[current] = true;
+
+		// passengers and goods can only change transport at transfer halts
+		if ( current != origin && !transfer_flags[current] )
+		{
+			continue;
+		}
+
+		for (uint32 e = working_edges.offsets[current]; e < working_edges.offsets[current + 1]; ++e)
+		{
+			const direct_edge_t &edge = working_edges.edges[e];
+			const uint16 transport = get_transport_index(edge);
+
+			// as in explore_transfer(), a journey never continues on the same line or convoy
+			if ( current != origin && transport != 0 && transports[current].last_transport == transport )
+			{
+				continue;
+			}
+
+			const uint64 combined_time = (uint64)current_time + edge.aggregate_time;
+			if ( !settled[edge.target] && combined_time < row[edge.target].aggregate_time )
+			{
+				row[edge.target].aggregate_time = (uint32)combined_time;
+				row[edge.target].next_transfer = ( current == origin ? working_halt_list[edge.target] : row[current].next_transfer );
+				transports[edge.target].first_transport = ( current == origin ? transport : transports[current].first_transport );
+				transports[edge.target].last_transport = transport;
+				search_heap.insert( search_node_t(row[edge.target].aggregate_time, edge.target) );
+			}
+		}
+		iterations_done += working_edges.offsets[current + 1] - working_edges.offsets[current];
+	}
+
+	return iterations_done;
+}
+
+
+uint32 path_explorer_t::compartment_t::relax_faster_connexion(const changed_connexion_t &connexion, const uint16 origin)
+{
+	const uint16 u = connexion.origin;
+	const uint16 v = connexion.edge.target;
+
+	if ( origin == v || ( origin != u && !transfer_flags[u] ) )
+	{
+		return 1;
+	}
+	const uint32 to_u = ( origin == u ? 0u : working_matrix[origin][u].aggregate_time );
+	if ( to_u == UINT32_MAX_VALUE )
+	{
+		return 1;
+	}
+
+	// as in explore_transfer(), a journey never continues on the same line or convoy
+	const uint16 transport = get_transport_index(connexion.edge);
+	if ( origin != u && transport != 0 && transport_matrix[origin][u].last_transport == transport )
+	{
+		return 1;
+	}
+
+	const uint64 to_v = (uint64)to_u + connexion.edge.aggregate_time;
+	if ( to_v >= working_matrix[origin][v].aggregate_time )
+	{
+		// if the connexion does not improve reaching v, it does not improve anything beyond v either
+		return 1;
+	}
+	const halthandle_t first_transfer = ( origin == u ? working_halt_list[v] : working_matrix[origin][u].next_transfer );
+	const uint16 first_transport = ( origin == u ? transport : transport_matrix[origin][u].first_transport );
+	working_matrix[origin][v].aggregate_time = (uint32)to_v;
+	working_matrix[origin][v].next_transfer = first_transfer;
+	transport_matrix[origin][v].first_transport = first_transport;
+	transport_matrix[origin][v].last_transport = transport;
+
+	if ( !transfer_flags[v] )
+	{
+		return 1;
+	}
+	for (uint16 j = 0; j < working_halt_count; ++j)
+	{
+		const uint32 from_v = working_matrix[v][j].aggregate_time;
+		if ( j == v || j == origin || from_v == UINT32_MAX_VALUE
+			 || ( transport != 0 && transport_matrix[v][j].first_transport == transport ) )
+		{
+			continue;
+		}
+		const uint64 combined_time = to_v + from_v;
+		if ( combined_time < working_matrix[origin][j].aggregate_time )
+		{
+			working_matrix[origin][j].aggregate_time = (uint32)combined_time;
+			working_matrix[origin][j].next_transfer = first_transfer;
+			transport_matrix[origin][j].first_transport = first_transport;
+			transport_matrix[origin][j].last_transport = transport_matrix[v][j].last_transport;
+		}
+	}
+	return working_halt_count;
+}
+
+
+void path_explorer_t::compartment_t::publish_working_paths(path_matrix_t *shared_paths)
+{
+	// path search completed -> delete old path info
+	if (finished_matrix)
+	{
+		finished_matrix->release();
+		finished_matrix = NULL;
+	}
+	if (finished_halt_index_map)
+	{
+		delete[] finished_halt_index_map;
+		finished_halt_index_map = NULL;
+	}
+
+	// transfer working to finished : the working matrix is repacked into compact storage row by row
+	if (shared_paths)
+	{
+		shared_paths->add_reference();
+		finished_matrix = shared_paths;
+	}
+	else if (working_matrix)
+	{
+		finished_matrix = new path_matrix_t(working_halt_count);
+	}
+	if (working_matrix)
+	{
+		for (uint16 i = 0; i < working_halt_count; ++i)
+		{
+			if (!shared_paths)
+			{
+				finished_matrix->set_row(i, working_matrix[i]);
+			}
+			delete[] working_matrix[i];
+		}
+		delete[] working_matrix;
+		working_matrix = NULL;
+	}
+	finished_halt_index_map = working_halt_index_map;
+	working_halt_index_map = NULL;
+	finished_halt_count = working_halt_count;
+	// working_halt_count is reset below after deleting transport matrix
+
+	// keep the connexions and transfers which the paths are based on for the next incremental update
+	swap(finished_edges.edges, working_edges.edges);
+	swap(finished_edges.offsets, working_edges.offsets);
+	working_edges.clear();
+	finished_transfers.clear();
+	for (uint16 i = 0; i < transfer_count; ++i)
+	{
+		finished_transfers.append(transfer_list[i]);
+	}
+
+	// path search completed -> delete auxilliary data structures
+	if (transport_matrix)
+	{
+		for (uint16 i = 0; i < working_halt_count; ++i)
+		{
+			delete[] transport_matrix[i];
+		}
+		delete[] transport_matrix;
+		transport_matrix = NULL;
+	}
+	working_halt_count = 0;
+	if (transfer_list)
+	{
+		delete[] transfer_list;
+		transfer_list = NULL;
+	}
+	transfer_count = 0;
+
+	if (inbound_connections)
+	{
+		delete inbound_connections;
+		inbound_connections = NULL;
+	}
+	if (outbound_connections)
+	{
+		delete outbound_connections;
+		outbound_connections = NULL;
+	}
+	process_next_transfer = true;
+}
+
+
 bool path_explorer_t::compartment_t::get_path_between(const halthandle_t origin_halt, const halthandle_t target_halt,
 													  uint32 &aggregate_time, halthandle_t &next_transfer)
 {
@@ -1999,10 +2731,9 @@ bool path_explorer_t::compartment_t::get_path_between(const halthandle_t origin_
 	if ( paths_available /*&& origin_halt.is_bound() && target_halt.is_bound()*/
 			&& ( origin_index = finished_halt_index_map[ origin_halt.get_id() ] ) != 65535
 			&& ( target_index = finished_halt_index_map[ target_halt.get_id() ] ) != 65535
-			&& finished_matrix[origin_index][target_index].next_transfer.is_bound() )
+			&& ( next_transfer = finished_matrix->get_next_transfer(origin_index, target_index) ).is_bound() )
 	{
-		aggregate_time = finished_matrix[origin_index][target_index].aggregate_time;
-		next_transfer = finished_matrix[origin_index][target_index].next_transfer;
+		aggregate_time = finished_matrix->get_aggregate_time(origin_index, target_index);
 		return true;
 	}
 
@@ -2118,14 +2849,16 @@ void path_explorer_t::compartment_t::rdwr(loadsave_t* file)
 	{
 		if (file->is_saving())
 		{
+			uint32 tmp_time;
 			uint16 tmp_idx;
 			for (uint16 i = 0; i < finished_halt_count; i++)
 			{
 				//  This is a 2 dimensional array
-				for (uint32 j = 0; j < finished_halt_count; j++)
+				for (uint16 j = 0; j < finished_halt_count; j++)
 				{
-					file->rdwr_long(finished_matrix[i][j].aggregate_time);
-					tmp_idx = finished_matrix[i][j].next_transfer.get_id();
+					tmp_time = finished_matrix->get_aggregate_time(i, j);
+					file->rdwr_long(tmp_time);
+					tmp_idx = finished_matrix->get_next_transfer_id(i, j);
 					file->rdwr_short(tmp_idx);
 				}
 			}
@@ -2136,21 +2869,18 @@ void path_explorer_t::compartment_t::rdwr(loadsave_t* file)
 			if (finished_halt_count > 0)
 			{
 				// Build the (empty) finished matrix
+				uint32 tmp_time;
 				uint16 tmp_idx;
-				finished_matrix = new path_element_t*[finished_halt_count];
-				for (uint16 i = 0; i < finished_halt_count; ++i)
-				{
-					finished_matrix[i] = new path_element_t[finished_halt_count];
-				}
+				finished_matrix = new path_matrix_t(finished_halt_count);
 
-				// Now load them. These are 2 dimensional arrays.
+				// Now load it. This is a 2 dimensional array.
 				for (uint16 i = 0; i < finished_halt_count; i++)
 				{
-					for (uint32 j = 0; j < finished_halt_count; j++)
+					for (uint16 j = 0; j < finished_halt_count; j++)
 					{
-						file->rdwr_long(finished_matrix[i][j].aggregate_time);
+						file->rdwr_long(tmp_time);
 						file->rdwr_short(tmp_idx);
-						finished_matrix[i][j].next_transfer.set_id(tmp_idx);
+						finished_matrix->set(i, j, tmp_time, tmp_idx);
 					}
 				}
 			}
@@ -2416,6 +3146,18 @@ void path_explorer_t::compartment_t::rdwr(loadsave_t* file)
 
 	file->rdwr_long(statistic_duration);
 	file->rdwr_long(statistic_iteration);
+
+	if (file->is_loading())
+	{
+		// the connexions behind the finished paths are not saved, so the next refresh explores all paths anyway
+		incremental_refresh_count = 0;
+
+		if (current_phase == phase_update_paths)
+		{
+			// the state of an incremental update is not saved : refresh anew
+			reset(false);
+		}
+	}
 }
 
 void path_explorer_t::compartment_t::connection_t::rdwr(loadsave_t* file)
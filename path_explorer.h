@@ -18,6 +18,7 @@
 #include "simdebug.h"
 
 #include "tpl/vector_tpl.h"
+#include "tpl/binary_heap_tpl.h"
 #include "tpl/quickstone_hashtable_tpl.h"
 
 
@@ -136,6 +137,93 @@ private:
 			{}
 		};
 
+		// compact storage for calculated paths :
+		// aggregate times and next transfer halt ids are kept in two separate contiguous arrays
+		// in row-major order, avoiding both the padding of path_element_t and one allocation per row.
+		// A finished matrix is never modified, so compartments with identical connexions
+		// can share one : it is reference counted and deleted by the last release().
+		class path_matrix_t
+		{
+		private:
+			uint32 *aggregate_times;
+			uint16 *next_transfers;
+			uint16 halt_count;
+			uint16 reference_count;
+
+			uint32 index_of(const uint16 origin, const uint16 target) const { return (uint32)origin * halt_count + target; }
+
+			~path_matrix_t()
+			{
+				delete[] aggregate_times;
+				delete[] next_transfers;
+			}
+
+		public:
+			explicit path_matrix_t(const uint16 count) :
+				aggregate_times(new uint32[(uint32)count * count]),
+				next_transfers(new uint16[(uint32)count * count]),
+				halt_count(count),
+				reference_count(1)
+			{}
+
+			void add_reference() { ++reference_count; }
+
+			void release()
+			{
+				if( --reference_count == 0 )
+				{
+					delete this;
+				}
+			}
+
+			bool is_shared() const { return reference_count > 1; }
+
+			uint16 get_halt_count() const { return halt_count; }
+
+			uint32 get_aggregate_time(const uint16 origin, const uint16 target) const { return aggregate_times[ index_of(origin, target) ]; }
+
+			halthandle_t get_next_transfer(const uint16 origin, const uint16 target) const
+			{
+				halthandle_t halt;
+				halt.set_id( next_transfers[ index_of(origin, target) ] );
+				return halt;
+			}
+
+			uint16 get_next_transfer_id(const uint16 origin, const uint16 target) const { return next_transfers[ index_of(origin, target) ]; }
+
+			void set(const uint16 origin, const uint16 target, const uint32 aggregate_time, const uint16 next_transfer_id)
+			{
+				const uint32 index = index_of(origin, target);
+				aggregate_times[index] = aggregate_time;
+				next_transfers[index] = next_transfer_id;
+			}
+
+			// copies one row of a working matrix
+			void set_row(const uint16 origin, const path_element_t *const row)
+			{
+				const uint32 start = index_of(origin, 0);
+				for (uint16 j = 0; j < halt_count; ++j)
+				{
+					aggregate_times[start + j] = row[j].aggregate_time;
+					next_transfers[start + j] = row[j].next_transfer.get_id();
+				}
+			}
+
+			void get_row(const uint16 origin, path_element_t *const row) const
+			{
+				const uint32 start = index_of(origin, 0);
+				for (uint16 j = 0; j < halt_count; ++j)
+				{
+					row[j].aggregate_time = aggregate_times[start + j];
+					row[j].next_transfer.set_id( next_transfers[start + j] );
+				}
+			}
+
+		private:
+			path_matrix_t(const path_matrix_t&);
+			path_matrix_t& operator=(const path_matrix_t&);
+		};
+
 		// element used during path search only for storing best lines/convoys
 		struct transport_element_t
 		{
@@ -268,11 +356,83 @@ private:
 			convoihandle_t convoy;
 		};
 
+		// a direct connexion between two matrix indices, used for incremental refresh;
+		// transport is the line id, or 65536 + the lineless convoy id, or 0 for walking,
+		// which stays the same across refreshes unlike the indices of transport_index_map.
+		// The first and the last transport of a direct connexion are the same.
+		struct direct_edge_t
+		{
+			uint16 target;
+			uint32 aggregate_time;
+			uint32 transport;
+
+			bool operator==(const direct_edge_t &other) const
+			{
+				return target == other.target && aggregate_time == other.aggregate_time && transport == other.transport;
+			}
+			bool operator!=(const direct_edge_t &other) const { return !( *this == other ); }
+		};
+
+		// a compact adjacency list of direct connexions : the edges of origin i are
+		// stored in edges[ offsets[i] ] to edges[ offsets[i+1] - 1 ], sorted by target
+		struct edge_list_t
+		{
+			vector_tpl<direct_edge_t> edges;
+			vector_tpl<uint32> offsets;
+
+			void clear() { edges.clear(); offsets.clear(); }
+			bool empty() const { return offsets.empty(); }
+
+			bool is_equal(const edge_list_t &other) const
+			{
+				if( edges.get_count() != other.edges.get_count() || offsets.get_count() != other.offsets.get_count() )
+				{
+					return false;
+				}
+				for( uint32 i = 0; i < offsets.get_count(); ++i )
+				{
+					if( offsets[i] != other.offsets[i] )
+					{
+						return false;
+					}
+				}
+				for( uint32 i = 0; i < edges.get_count(); ++i )
+				{
+					if( edges[i] != other.edges[i] )
+					{
+						return false;
+					}
+				}
+				return true;
+			}
+		};
+
+		// a direct connexion which has changed since the last refresh
+		struct changed_connexion_t
+		{
+			uint16 origin;
+			direct_edge_t edge;
+		};
+
+		// a halt reached in search_paths_from() : the aggregate time in the upper bits and the matrix
+		// index in the lower ones, so that ties go to the lowest index and all clients agree
+		struct search_node_t
+		{
+			uint64 key;
+
+			search_node_t(const uint32 aggregate_time, const uint16 index) : key( ( (uint64)aggregate_time << 16 ) | index ) {}
+			search_node_t() : key(0) {}
+			// dereferencing to be used in binary_heap_tpl
+			inline uint64 operator * () const { return key; }
+			uint32 get_aggregate_time() const { return (uint32)( key >> 16 ); }
+			uint16 get_index() const { return (uint16)key; }
+		};
+
 		// store the start time of refresh
 		sint64 refresh_start_time;
 
 		// set of variables for finished path data
-		path_element_t **finished_matrix;
+		path_matrix_t *finished_matrix;
 		uint16 *finished_halt_index_map;
 		uint16 finished_halt_count;
 
@@ -295,6 +455,29 @@ private:
 		uint16 *transfer_list;
 		uint16 transfer_count;
 
+		// direct connexions and transfers from which the finished matrix was computed,
+		// and those of the current refresh; compared to decide on an incremental update
+		edge_list_t finished_edges;
+		vector_tpl<uint16> finished_transfers;
+		edge_list_t working_edges;
+
+		// state of an incremental update of the working matrix; it is not saved,
+		// as a game loaded in the middle of an update refreshes its paths anew
+		uint8 update_stage;
+		uint32 update_connexion_index;
+		bool *transfer_flags;
+		bool *row_affected;
+		vector_tpl<uint16> affected_rows;
+		vector_tpl<changed_connexion_t> faster_connexions;	// new or faster connexions
+		vector_tpl<changed_connexion_t> broken_connexions;	// removed or slower connexions, or those of another transport
+		bool *search_settled;
+		binary_heap_tpl<search_node_t> search_heap;
+
+		// Paths derived from earlier paths may keep times which are no longer achievable, as the
+		// affected origins are only found along the next transfers. Thus after this many
+		// incremental updates in a row, all paths are explored anew.
+		uint8 incremental_refresh_count;
+
 		uint8 catg;				// category managed by this compartment
 		uint8 g_class;			// Class managed by this compartment
 		const char *catg_name;	// Name of the category
@@ -378,6 +561,15 @@ private:
 		static const uint8 phase_fill_matrix = 4;
 		static const uint8 phase_explore_paths = 5;
 		static const uint8 phase_reroute_goods = 6;
+		static const uint8 phase_update_paths = 7;
+
+		// stages of an incremental update
+		static const uint8 update_stage_analyse = 0;
+		static const uint8 update_stage_copy = 1;
+		static const uint8 update_stage_search = 2;
+		static const uint8 update_stage_relax = 3;
+
+		static const uint8 max_incremental_refreshes = 8;
 
 		// absolute time limits
 		// The higher this number, the more processing will be done per step and the more quickly that a refresh will complete, but the more computationally intensive that it will be.
@@ -394,9 +586,68 @@ private:
 		static const uint32 percent_lower_limit = 100 - percent_deviation;
 		static const uint32 percent_upper_limit = 100 + percent_deviation;
 
-		void enumerate_all_paths(const path_element_t *const *const matrix, const halthandle_t *const halt_list,
+		void enumerate_all_paths(const path_matrix_t *const matrix, const halthandle_t *const halt_list,
 								 const uint16 *const halt_map, const uint16 halt_count);
 
+		// collect the direct connexions of the freshly filled working matrix into working_edges
+		void collect_working_edges();
+
+		// whether the finished paths of source were computed over the same halts and transfers as the working set
+		bool has_same_halts_as_finished(const compartment_t &source) const;
+
+		// find a compartment of a lower class of the same category whose finished paths
+		// were computed from connexions identical to the working set, served by the same transports
+		path_matrix_t *find_identical_class_paths() const;
+
+		// Collect the changes in direct connexions since the last refresh, from which the
+		// working matrix may be derived from the finished matrix in phase_update_paths.
+		// Returns false when the halt set differs or there are too many faster connexions.
+		bool prepare_incremental_update();
+
+		// release the state of an incremental update
+		void clear_incremental_update();
+
+		// the direct connexion from origin to target in working_edges, or NULL
+		const direct_edge_t *find_working_edge(const uint16 origin, const uint16 target) const;
+
+		// the index of the transport of a direct connexion in transport_matrix
+		uint16 get_transport_index(const direct_edge_t &edge) const { return edge.transport ? transport_index_map[edge.transport] : 0u; }
+
+		// whether the connexion from origin to target is among broken_connexions
+		bool is_broken_connexion(const uint16 origin, const uint16 target) const;
+
+		// the matrix index of the finished next transfer from origin towards target, or 65535
+		uint16 get_finished_next_index(const uint16 origin, const uint16 target) const;
+
+		// Follow the finished next transfers of all halts towards target, as goods travel.
+		// If analyse is set, mark the origins whose goods would travel over a broken connexion;
+		// otherwise store the first and last transport of each journey in the transport matrix.
+		// Returns the iterations done.
+		uint32 resolve_finished_chains(const uint16 target, uint32 *const chain_values, const bool analyse);
+
+		// copy the finished paths towards target into the working matrix and transport matrix.
+		// Returns the iterations done.
+		uint32 copy_finished_column(const uint16 target, uint32 *const chain_values);
+
+		// recompute a single row of the working matrix and transport matrix from working_edges.
+		// Returns the iterations done.
+		uint32 search_paths_from(const uint16 origin);
+
+		// relax the paths of origin through a faster connexion. Returns the iterations done.
+		uint32 relax_faster_connexion(const changed_connexion_t &connexion, const uint16 origin);
+
+		// relax the paths of the origins assigned to thread_number out of thread_count
+		// through transfer via, for the origin clusters from origin_cluster_index up to
+		// origin_cluster_end; paths of different origins never depend on each other here
+		void explore_transfer(const uint16 via, const uint32 origin_cluster_end, const uint32 thread_number, const uint32 thread_count);
+
+		// number of path relaxations for an origin cluster of the current transfer, used for iteration control
+		uint64 count_cluster_iterations(const uint32 origin_cluster) const;
+
+		// move the working set to the finished set once path search is done;
+		// if shared_paths is given, it is referenced instead of the working matrix
+		void publish_working_paths(path_matrix_t *shared_paths = NULL);
+
 	public:
 
 		compartment_t();
@@ -498,10 +749,24 @@ private:
 	static uint8 current_compartment_class;
 	static bool processing;
 
+#ifdef MULTI_THREAD_PATH_EXPLORER
+	// number of threads sharing the exploration of a transfer, including the one stepping the path explorer
+	static uint32 explore_thread_count;
+	static compartment_t *exploring_compartment;
+	static uint16 exploring_via;
+	static uint32 exploring_origin_cluster_end;
+
+	static void explore_transfer_in_parallel(compartment_t *compartment, const uint16 via, const uint32 origin_cluster_end);
+#endif
+
 public:
 #ifdef MULTI_THREAD
 	static thread_local bool allow_path_explorer_on_this_thread;
 	friend void *path_explorer_threaded(void* args);
+#endif
+#ifdef MULTI_THREAD_PATH_EXPLORER
+	static void set_explore_thread_count(const uint32 count) { explore_thread_count = count > 0 ? count : 1; }
+	static void explore_transfer_worker(const uint32 thread_number);
 #endif
 	static void initialise(karte_t *welt);
 	static void finalise();
@@ -52,6 +52,7 @@
 
 #include "utils/simrandom.h"
 #include "utils/simstring.h"
+#include "utils/step_profiler.h"
 
 #include "vehicle/pedestrian.h"
 #include "vehicle/road_vehicle.h"
@@ -2426,6 +2427,55 @@ bool haltestelle_t::fetch_goods(slist_tpl<ware_t> &load, const goods_desc_t *goo
 	vector_tpl<ware_t> *warray = cargo[catg_index];
 	if(warray && warray->get_count() > 0)
 	{
+		halthandle_t cached_halts[256];
+
+		// The halts at which this convoy calls before it returns here, found by the same walk
+		// along the schedule as below. Only packets bound for one of them can be loaded, so
+		// there is no need to sort the others by arrival time and to walk the schedule for them.
+		vector_tpl<halthandle_t> calling_halts(schedule->get_count());
+		{
+			uint8 index = schedule->get_current_stop();
+			bool reverse = cnv->get_reverse_schedule();
+			if(cnv->get_state() != convoi_t::REVERSING)
+			{
+				schedule->increment_index(&index, &reverse);
+			}
+
+			int count = 0;
+			while(index != schedule->get_current_stop() || (cnv->get_state() == convoi_t::REVERSING && count == 0))
+			{
+				halthandle_t& schedule_halt = cached_halts[index];
+				if(schedule_halt.is_null())
+				{
+					schedule_halt = haltestelle_t::get_halt(schedule->entries[index].pos, player);
+				}
+
+				if(schedule_halt == self)
+				{
+					if(count == 0)
+					{
+						schedule->increment_index(&index, &reverse);
+						continue;
+					}
+					break;
+				}
+
+				count ++;
+
+				if(schedule_halt.is_bound() && schedule_halt->is_enabled(catg_index))
+				{
+					calling_halts.append_unique(schedule_halt);
+				}
+
+				if(schedule->is_mirrored() && (index == 0 || index == (schedule->get_count() - 1)))
+				{
+					break;
+				}
+
+				schedule->increment_index(&index, &reverse);
+			}
+		}
+
 		binary_heap_tpl<ware_t*> goods_to_check;
 		for(uint32 i = 0;  i < warray->get_count();  )
 		{
@@ -2443,7 +2493,8 @@ bool haltestelle_t::fetch_goods(slist_tpl<ware_t> &load, const goods_desc_t *goo
 					// we ALSO cannot load passengers or mail of a higher class into lower class accomodation.
 					// This fixes a bug where priority mail would load into a normal mail vehicle in the front even if
 					// there was a priority mail vehicle later in the consist (and similarly for passengers).
-					if(  use_lower_classes || ware->get_class() == g_class  )
+					if(  (use_lower_classes || ware->get_class() == g_class)  &&
+						(calling_halts.is_contained(ware->get_zwischenziel()) || calling_halts.is_contained(ware->get_ziel()))  )
 					{
 						goods_to_check.insert(ware);
 					}
@@ -2461,8 +2512,16 @@ bool haltestelle_t::fetch_goods(slist_tpl<ware_t> &load, const goods_desc_t *goo
 			}
 		}
 
-		halthandle_t cached_halts[256];
-
+		// calc_earliest_arrival_time_at() is asked for every packet, but the answer depends
+		// only on the next transfer and the class, which many packets share.
+		struct earliest_arrival_t
+		{
+			halthandle_t halt;
+			uint8 g_class;
+			sint64 arrival_time;
+			convoihandle_t convoy;
+		};
+		vector_tpl<earliest_arrival_t> earliest_arrivals;
 
 		while(!goods_to_check.empty())
 		{
@@ -2514,7 +2573,30 @@ bool haltestelle_t::fetch_goods(slist_tpl<ware_t> &load, const goods_desc_t *goo
 					sint64 best_arrival_time;
 					if (bound_for_next_transfer)
 					{
-						best_arrival_time = calc_earliest_arrival_time_at(next_transfer, fast_convoy, catg_index, next_to_load->g_class);
+						const earliest_arrival_t *known = NULL;
+						for(earliest_arrival_t const& e : earliest_arrivals)
+						{
+							if(e.halt == next_transfer && e.g_class == next_to_load->g_class)
+							{
+								known = &e;
+								break;
+							}
+						}
+						if(known)
+						{
+							best_arrival_time = known->arrival_time;
+							fast_convoy = known->convoy;
+						}
+						else
+						{
+							best_arrival_time = calc_earliest_arrival_time_at(next_transfer, fast_convoy, catg_index, next_to_load->g_class);
+							earliest_arrival_t e;
+							e.halt = next_transfer;
+							e.g_class = next_to_load->g_class;
+							e.arrival_time = best_arrival_time;
+							e.convoy = fast_convoy;
+							earliest_arrivals.append(e);
+						}
 					}
 					else
 					{
@@ -4534,6 +4616,7 @@ void haltestelle_t::rdwr(loadsave_t *file)
 				file->rdwr_longlong(time);
 				estimated_convoy_departure_times.put(convoy_id, time);
 			}
+			rebuild_departure_board();
 		}
 	}
 
@@ -4776,10 +4859,8 @@ void haltestelle_t::rdwr(loadsave_t *file)
 }
 
 
-void haltestelle_t::finish_rd(bool need_recheck_for_walking_distance)
+void haltestelle_t::finish_rd_cargo()
 {
-	stale_convois.clear();
-	stale_lines.clear();
 	// fix good destination coordinates
 	for(uint8 i = 0; i < goods_manager_t::get_max_catg_index(); i++)
 	{
@@ -4789,27 +4870,60 @@ void haltestelle_t::finish_rd(bool need_recheck_for_walking_distance)
 			for(ware_t & j : *warray) {
 				j.finish_rd(welt);
 			}
+
 			// merge identical entries (should only happen with old games)
+			// Sorting by the merge criteria and then by position makes identical entries adjacent,
+			// with the first one in the list leading; comparing every pair is far too slow for large stops.
 			const uint32 count = warray->get_count();
+			if(count < 2)
+			{
+				continue;
+			}
+			vector_tpl<uint32> order(count);
+			for(uint32 j = 0; j < count; ++j)
+			{
+				order.append(j);
+			}
+			std::sort(order.begin(), order.end(), [warray](const uint32 a, const uint32 b) {
+				const ware_t &wa = (*warray)[a];
+				const ware_t &wb = (*warray)[b];
+				if(wa.get_zwischenziel().get_id() != wb.get_zwischenziel().get_id()) return wa.get_zwischenziel().get_id() < wb.get_zwischenziel().get_id();
+				if(wa.get_index() != wb.get_index()) return wa.get_index() < wb.get_index();
+				if(wa.get_ziel().get_id() != wb.get_ziel().get_id()) return wa.get_ziel().get_id() < wb.get_ziel().get_id();
+				if(wa.get_zielpos().x != wb.get_zielpos().x) return wa.get_zielpos().x < wb.get_zielpos().x;
+				if(wa.get_zielpos().y != wb.get_zielpos().y) return wa.get_zielpos().y < wb.get_zielpos().y;
+				if(wa.get_origin().get_id() != wb.get_origin().get_id()) return wa.get_origin().get_id() < wb.get_origin().get_id();
+				if(wa.get_last_transfer().get_id() != wb.get_last_transfer().get_id()) return wa.get_last_transfer().get_id() < wb.get_last_transfer().get_id();
+				if(wa.get_class() != wb.get_class()) return wa.get_class() < wb.get_class();
+				return a < b;
+			});
+			ware_t *lead = NULL;
 			for(uint32 j = 0; j < count; ++j)
 			{
-				ware_t& warj = (*warray)[j];
-				if(warj.menge == 0)
+				ware_t& ware = (*warray)[order[j]];
+				if(ware.menge == 0)
 				{
 					continue;
 				}
-				for(uint32 k = j + 1; k < count; ++k)
+				if(lead && lead->can_merge_with(ware))
 				{
-					ware_t& wark = (*warray)[k];
-					if(wark.menge > 0 && warj.can_merge_with(wark))
-					{
-						warj.menge += wark.menge;
-						wark.menge = 0;
-					}
+					lead->menge += ware.menge;
+					ware.menge = 0;
+				}
+				else
+				{
+					lead = &ware;
 				}
 			}
 		}
 	}
+}
+
+
+void haltestelle_t::finish_rd(bool need_recheck_for_walking_distance)
+{
+	stale_convois.clear();
+	stale_lines.clear();
 
 	// handle name for old stations which don't exist in kartenboden
 	// also recover from stations without tiles (from broken savegames)
@@ -6453,15 +6567,52 @@ void haltestelle_t::set_estimated_arrival_time(uint16 convoy_id, sint64 time)
 
 void haltestelle_t::set_estimated_departure_time(uint16 convoy_id, sint64 time)
 {
+	remove_from_departure_board(convoy_id);
 	estimated_convoy_departure_times.set(convoy_id, time);
+
+	departure_t dep;
+	dep.time = time;
+	dep.convoy_id = convoy_id;
+	departure_board.insert_ordered(dep, departure_t::compare);
 }
 
 void haltestelle_t::clear_estimated_timings(uint16 convoy_id)
 {
+	remove_from_departure_board(convoy_id);
 	estimated_convoy_arrival_times.remove(convoy_id);
 	estimated_convoy_departure_times.remove(convoy_id);
 }
 
+void haltestelle_t::remove_from_departure_board(uint16 convoy_id)
+{
+	if(!estimated_convoy_departure_times.is_contained(convoy_id))
+	{
+		return;
+	}
+	departure_t dep;
+	dep.time = estimated_convoy_departure_times.get(convoy_id);
+	dep.convoy_id = convoy_id;
+	departure_t* const i = std::lower_bound(departure_board.begin(), departure_board.end(), dep, departure_t::compare);
+	if(i != departure_board.end() && i->convoy_id == convoy_id)
+	{
+		departure_board.remove_at(i - departure_board.begin());
+	}
+}
+
+void haltestelle_t::rebuild_departure_board()
+{
+	departure_board.clear();
+	departure_board.resize(estimated_convoy_departure_times.get_count());
+	FOR(arrival_times_map, const& iter, estimated_convoy_departure_times)
+	{
+		departure_t dep;
+		dep.time = iter.value;
+		dep.convoy_id = iter.key;
+		departure_board.append(dep);
+	}
+	std::sort(departure_board.begin(), departure_board.end(), departure_t::compare);
+}
+
 void haltestelle_t::add_line(linehandle_t line)
 {
 	registered_lines.append_unique(line);
@@ -6562,13 +6713,22 @@ void haltestelle_t::clear_service_intervals(schedule_t* sch)
 
 sint64 haltestelle_t::calc_earliest_arrival_time_at(halthandle_t halt, convoihandle_t &convoy, uint8 catg_index, uint8 g_class) const
 {
+	step_profiler_t::count_earliest_arrival_query();
+
 	const arrival_times_map& next_transfer_arrivals = halt->get_estimated_convoy_arrival_times();
 	sint64 best_arrival_time = SINT64_MAX_VALUE;
 	sint64 current_time;
 	convoihandle_t arrival_convoy;
-	FOR(arrival_times_map, const& iter, estimated_convoy_departure_times)
+	for(departure_t const& dep : departure_board)
 	{
-		arrival_convoy.set_id(iter.key);
+		if(dep.time >= best_arrival_time)
+		{
+			// No convoy arrives before it departs, and delays only add to the arrival time,
+			// so neither this nor any later departure can arrive earlier.
+			break;
+		}
+
+		arrival_convoy.set_id(dep.convoy_id);
 		if(!arrival_convoy.is_bound())
 		{
 			continue;
@@ -6586,12 +6746,12 @@ sint64 haltestelle_t::calc_earliest_arrival_time_at(halthandle_t halt, convoihan
 			continue;
 		}
 
-		if(next_transfer_arrivals.is_contained(iter.key))
+		if(next_transfer_arrivals.is_contained(dep.convoy_id))
 		{
 			// Potentially relevant convoy - stops at the next transfer
-			current_time = next_transfer_arrivals.get(iter.key);
+			current_time = next_transfer_arrivals.get(dep.convoy_id);
 			// Check to see whether it has already left this stop but has not arrived at the destination yet.
-			if(current_time < iter.value)
+			if(current_time < dep.time)
 			{
 				// It is possible that this is faster even so.
 				// TODO: Add calculation code here based on the point to point times rather than skipping.
@@ -6599,7 +6759,7 @@ sint64 haltestelle_t::calc_earliest_arrival_time_at(halthandle_t halt, convoihan
 			}
 
 			// Check to see whether the convoy is running late.
-			const sint64 this_stop_arrival = estimated_convoy_arrival_times.get(iter.key);
+			const sint64 this_stop_arrival = estimated_convoy_arrival_times.get(dep.convoy_id);
 			if(this_stop_arrival <= welt->get_ticks() && !loading_here.is_contained(arrival_convoy))
 			{
 				// Assume that it will be as late again as it already is (e.g., if it is 2 minutes late so far, assume a total delay of 4 minutes)
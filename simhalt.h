@@ -496,6 +496,26 @@ private:
 	arrival_times_map estimated_convoy_arrival_times;
 	arrival_times_map estimated_convoy_departure_times;
 
+	/**
+	 * The entries of estimated_convoy_departure_times ordered by time, so that
+	 * calc_earliest_arrival_time_at() can stop at the first departure after the
+	 * best arrival found so far. Kept up to date by the setters below.
+	 */
+	struct departure_t
+	{
+		sint64 time;
+		uint16 convoy_id;
+
+		static bool compare(const departure_t &a, const departure_t &b)
+		{
+			return a.time < b.time  ||  (a.time == b.time  &&  a.convoy_id < b.convoy_id);
+		}
+	};
+	vector_tpl<departure_t> departure_board;
+
+	void remove_from_departure_board(uint16 convoy_id);
+	void rebuild_departure_board();
+
 	/**
 	 * Calculates the earliest time in ticks that passengers/mail/goods can arrive
 	 * at the given halt in light of the current estimated departure times.
@@ -803,6 +823,13 @@ public:
 
 	void rdwr(loadsave_t *file);
 
+	/**
+	 * Fixes the destinations of the waiting goods and merges identical packets after loading.
+	 * Must be called before finish_rd(). Only this stop is changed, so this may run for
+	 * several stops in parallel, unless the game is 111.5 or older (then halts are looked up).
+	 */
+	void finish_rd_cargo();
+
 	void finish_rd(bool need_recheck_for_walking_distance);
 
 	/**
@@ -6,6 +6,8 @@
 #include <stdio.h>
 #include <string>
 #include <new>
+#include <algorithm>
+#include <chrono>
 
 #include "pathes.h"
 
@@ -13,6 +15,7 @@
 #include "simworld.h"
 #include "simware.h"
 #include "display/simview.h"
+#include "display/viewport.h"
 #include "gui/simwin.h"
 #include "gui/gui_theme.h"
 #include "gui/messagebox.h"
@@ -74,6 +77,7 @@
 
 #include "utils/cbuffer_t.h"
 #include "utils/simrandom.h"
+#include "utils/step_profiler.h"
 
 #include "bauer/vehikelbauer.h"
 
@@ -199,6 +203,86 @@ static void show_times(karte_t *welt, main_view_t *view)
 #endif
 
 
+static uint64 get_render_microseconds()
+{
+	return (uint64)std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+
+/* Renders the world into the screen buffer at the given zoom levels (comma
+ * separated, default is the current one) and always the same nine positions,
+ * and prints the frame times. Nothing is copied to the window, so only the
+ * drawing is measured; with SDL2, SDL_VIDEODRIVER=dummy runs without a screen.
+ */
+static void render_benchmark(karte_t *welt, main_view_t *view, int frames, const char *zoom_list, bool snapshot)
+{
+	intr_set_view(view);
+	intr_disable();
+#if COLOUR_DEPTH == 0
+	dbg->warning( "render_benchmark()", "Nothing is drawn without graphics, the times are meaningless" );
+#endif
+
+	vector_tpl<int> zooms;
+	for(  const char *p = zoom_list;  p  &&  *p;  ) {
+		zooms.append( clamp( atoi(p), 0, 9 ) );
+		p = strchr( p, ',' );
+		if(  p  ) {
+			p++;
+		}
+	}
+	if(  zooms.empty()  ) {
+		zooms.append( get_zoom_factor() );
+	}
+
+	// the centres of a 3x3 grid over the map, so runs can be compared
+	vector_tpl<koord> positions;
+	for(  int j = 0;  j < 3;  j++  ) {
+		for(  int i = 0;  i < 3;  i++  ) {
+			positions.append( koord( (welt->get_size().x * (2 * i + 1)) / 6, (welt->get_size().y * (2 * j + 1)) / 6 ) );
+		}
+	}
+
+	printf( "Render benchmark: %d frames at %u positions, %dx%d pixels, %d threads, times in microseconds\n",
+		frames, positions.get_count(), display_get_width(), display_get_height(), env_t::num_threads );
+	printf( "%-6s %9s %9s %9s %9s %9s\n", "zoom", "avg", "median", "95%", "max", "fps" );
+
+	vector_tpl<uint32> times( frames * positions.get_count() );
+	for(int const zoom : zooms) {
+		set_zoom_factor( zoom );
+		welt->get_viewport()->metrics_updated();
+
+		times.clear();
+		uint64 sum = 0;
+		for(koord const& pos : positions) {
+			welt->get_viewport()->change_world_position( pos );
+			// the first frame also prepares the tiles, hence it is not counted
+			view->display( true );
+			for(  int f = 0;  f < frames;  f++  ) {
+				const uint64 start = get_render_microseconds();
+				view->display( true );
+				const uint32 t = (uint32)(get_render_microseconds() - start);
+				times.append( t );
+				sum += t;
+			}
+		}
+		std::sort( times.begin(), times.end() );
+
+		const uint32 count = times.get_count();
+		const uint32 avg = (uint32)(sum / count);
+		printf( "%-6d %9u %9u %9u %9u %9.1f\n", get_zoom_factor(), avg, times[count / 2], times[(count * 95) / 100], times[count - 1], avg ? 1000000.0 / avg : 0.0 );
+		dbg->message( "render_benchmark()", "zoom %d: %u frames, average %u us", get_zoom_factor(), count, avg );
+
+		if(  snapshot  ) {
+			// the last frame, into the screenshot folder of the user directory
+			dr_chdir( env_t::user_dir );
+			if(  !display_snapshot( scr_rect( 0, 0, display_get_width(), display_get_height() ) )  ) {
+				dbg->warning( "render_benchmark()", "Could not save a screenshot" );
+			}
+		}
+	}
+}
+
+
 // some routines for the modal display
 static bool never_quit() { return false; }
 static bool no_language() { return translator::get_language()!=-1; }
@@ -350,6 +434,11 @@ void print_help()
 		" -objects DIR_NAME/  load the pakset in specified directory\n"
 		" -pause              starts game with paused after loading\n"
 		"                     a server will pause if there are no clients, even if this be not specified in simuconf.tab\n"
+		" -render_benchmark N renders N frames of the loaded world at nine positions,\n"
+		"                     prints the frame times and quits (see -render_zoom)\n"
+		" -render_png         with -render_benchmark, save the last frame of each zoom\n"
+		"                     level as screenshot\n"
+		" -render_zoom Z,...  zoom levels (0-9, 3 is unzoomed) for -render_benchmark\n"
 		" -res N              starts in specified resolution: \n"
 		"                      1=640x480, 2=800x600, 3=1024x768, 4=1280x1024\n"
 		" -screensize WxH     set screensize to width W and height H\n"
@@ -369,6 +458,8 @@ void print_help()
 		" -sizes              Show current size of some structures\n"
 #endif
 		" -startyear N        start in year N\n"
+		" -step_profile FILE  on quitting, print the time spent in each part of the\n"
+		"                     last world steps and write it as CSV to FILE\n"
 		" -theme N            user directory containing theme files\n"
 #ifdef MULTI_THREAD
 		" -threads N          use N threads if possible\n"
@@ -1506,6 +1597,12 @@ int simu_main(int argc, char** argv)
 	welt->set_fast_forward(false);
 	baum_t::recalc_outline_color();
 
+	// measure the drawing and quit
+	if(  const char *frames = args.gimme_arg("-render_benchmark", 1)  ) {
+		render_benchmark( welt, view, max( 1, atoi(frames) ), args.gimme_arg("-render_zoom", 1), args.has_arg("-render_png") );
+		env_t::quit_simutrans = true;
+	}
+
 	uint32 quit_month = 0x7FFFFFFFu;
 
 #if defined DEBUG || defined PROFILE
@@ -1618,6 +1715,22 @@ int simu_main(int argc, char** argv)
 		}
 	}
 
+	// dump the step profile (into the user directory unless a full path is given)
+	if(  const char *profile_filename = args.gimme_arg("-step_profile", 1)  ) {
+		cbuffer_t buf;
+		step_profiler_t::print(buf);
+		printf("%s", buf.get_str());
+		buf.clear();
+		step_profiler_t::print_csv(buf);
+		if(  FILE *f = dr_fopen(profile_filename, "w")  ) {
+			fputs(buf.get_str(), f);
+			fclose(f);
+		}
+		else {
+			dbg->warning("simu_main()", "Cannot write step profile to %s", profile_filename);
+		}
+	}
+
 	destroy_all_win( true );
 	tool_t::exit_menu();
 
@@ -93,6 +93,7 @@
 #include "utils/cbuffer_t.h"
 #include "utils/simrandom.h"
 #include "utils/simstring.h"
+#include "utils/step_profiler.h"
 
 #include "network/memory_rw.h"
 
@@ -155,6 +156,7 @@ simthread_barrier_t karte_t::private_car_barrier;
 simthread_barrier_t karte_t::unreserve_route_barrier;
 static simthread_barrier_t step_passengers_and_mail_barrier;
 static simthread_barrier_t path_explorer_barrier;
+static simthread_barrier_t path_explorer_workers_barrier;
 static simthread_barrier_t step_convoys_barrier_internal;
 simthread_barrier_t karte_t::step_convoys_barrier_external;
 
@@ -163,7 +165,21 @@ bool karte_t::threads_initialised = false;
 thread_local uint32 karte_t::passenger_generation_thread_number;
 thread_local uint32 karte_t::marker_index = UINT32_MAX_VALUE;
 
+// Convoys waiting for a route search, processed by the convoy worker threads.
+// Route searches differ greatly in cost, so each worker claims the next
+// unprocessed entry rather than taking a fixed share of the list.
 vector_tpl<convoihandle_t> convoys_next_step;
+static uint32 convoys_next_step_claimed = 0;
+static pthread_mutex_t convoys_next_step_mutex;
+
+// Autosaves are serialised into memory by the main thread, then this thread
+// compresses the snapshot into the file while the game goes on.
+static pthread_t background_save_thread;
+static bool background_save_running = false;
+static memory_rdwr_stream_t::buffer_t background_save_snapshot;
+static std::string background_save_filename;
+static loadsave_t::mode_t background_save_mode;
+static int background_save_level;
 
 vector_tpl<pedestrian_t*> *karte_t::pedestrians_added_threaded;
 vector_tpl<private_car_t*> *karte_t::private_cars_added_threaded;
@@ -488,6 +504,7 @@ void karte_t::destroy()
 	DBG_MESSAGE("karte_t::destroy()", "destroying world");
 
 #ifdef MULTI_THREAD
+	await_background_save();
 	suspend_private_car_threads();
 	destroy_threads();
 	DBG_MESSAGE("karte_t::destroy()", "threads destroyed");
@@ -544,6 +561,7 @@ void karte_t::destroy()
 	sync.clear();
 	sync_eyecandy.clear();
 	sync_way_eyecandy.clear();
+	sync_pedestrians.clear();
 	old_progress += cached_size.x*cached_size.y;
 	ls.set_progress( old_progress );
 	DBG_MESSAGE("karte_t::destroy()", "sync list cleared");
@@ -1847,11 +1865,16 @@ void *step_convoys_threaded(void* args)
 		}
 
 		// since convois will be deleted during stepping, we need to step backwards
+		// Only convoys set to ROUTING_2 in step() have anything to do here.
 		for (uint32 i = world->convoi_array.get_count(); i-- != 0;)
 		{
 			convoihandle_t cnv = world->convoi_array[i];
-			convoys_next_step.append(cnv);
+			if (cnv->get_state() == convoi_t::ROUTING_2)
+			{
+				convoys_next_step.append(cnv);
+			}
 		}
+		convoys_next_step_claimed = 0;
 
 		simthread_barrier_wait(&step_convoys_barrier_internal);
 		simthread_barrier_wait(&step_convoys_barrier_internal); // The multiples of these is intentional: we must wait for the individual threads to finish before the clear() command is executed.
@@ -1879,9 +1902,23 @@ void* step_individual_convoy_threaded(void* args)
 			return NULL;
 		}
 
+		// Each convoy's route depends only on its own data, the per thread marker
+		// and the per thread nodes, so the result does not depend on which thread
+		// picks which convoy. The results are used after await_convoy_threads().
 		const uint32 convoys_next_step_count = convoys_next_step.get_count();
-		for (uint32 i = thread_number; i < convoys_next_step_count; i += karte_t::world->get_parallel_operations())
+		while (true)
 		{
+			int error = pthread_mutex_lock(&convoys_next_step_mutex);
+			assert(error == 0);
+			const uint32 i = convoys_next_step_claimed++;
+			error = pthread_mutex_unlock(&convoys_next_step_mutex);
+			assert(error == 0);
+			(void)error;
+
+			if (i >= convoys_next_step_count)
+			{
+				break;
+			}
 			convoihandle_t cnv = convoys_next_step[i];
 			if (cnv.is_bound())
 			{
@@ -1973,6 +2010,36 @@ void* path_explorer_threaded(void* args)
 
 	return args;
 }
+
+#ifdef MULTI_THREAD_PATH_EXPLORER
+void* path_explorer_worker_threaded(void* args)
+{
+	const uint32* thread_number_ptr = (const uint32*)args;
+	const uint32 thread_number = *thread_number_ptr;
+	delete thread_number_ptr;
+
+	while (true)
+	{
+		simthread_barrier_wait(&path_explorer_workers_barrier);
+		if (karte_t::world->is_terminating_threads())
+		{
+			return NULL;
+		}
+		path_explorer_t::explore_transfer_worker(thread_number);
+		simthread_barrier_wait(&path_explorer_workers_barrier);
+	}
+
+	return args;
+}
+
+void karte_t::step_path_explorer_workers()
+{
+	// The thread stepping the path explorer takes the share of thread number 0.
+	simthread_barrier_wait(&path_explorer_workers_barrier);
+	path_explorer_t::explore_transfer_worker(0);
+	simthread_barrier_wait(&path_explorer_workers_barrier);
+}
+#endif
 #endif
 
 void karte_t::await_path_explorer()
@@ -2097,6 +2164,7 @@ void karte_t::init_threads()
 	simthread_barrier_init(&step_convoys_barrier_external, NULL, 2);
 	simthread_barrier_init(&step_convoys_barrier_internal, NULL, parallel_operations + 1);
 	simthread_barrier_init(&path_explorer_barrier, NULL, 2);
+	simthread_barrier_init(&path_explorer_workers_barrier, NULL, parallel_operations + 1);
 
 	// Initialise mutexes
 	pthread_mutexattr_init(&mutex_attributes);
@@ -2108,6 +2176,7 @@ void karte_t::init_threads()
 	pthread_mutex_init(&step_passengers_and_mail_mutex, &mutex_attributes);
 	pthread_mutex_init(&path_explorer_await_mutex, &mutex_attributes);
 	pthread_mutex_init(&unreserve_route_mutex, &mutex_attributes);
+	pthread_mutex_init(&convoys_next_step_mutex, &mutex_attributes);
 
 	pthread_t thread;
 
@@ -2194,6 +2263,23 @@ void karte_t::init_threads()
 		dbg->fatal("void karte_t::init_threads()", "Failed to create path explorer thread, error %d. See here for a translation of the error numbers: http://epydoc.sourceforge.net/stdlib/errno-module.html", rc);
 	}
 	path_explorer_working = false;
+
+	// Helpers sharing the path exploration of each transfer with the path explorer thread
+	for (sint32 i = 0; i < parallel_operations; i++)
+	{
+		uint32* thread_number_explorer = new uint32;
+		*thread_number_explorer = i + 1; // +1 because thread number 0 is the path explorer thread itself.
+		rc = pthread_create(&thread, &thread_attributes, &path_explorer_worker_threaded, (void*)thread_number_explorer);
+		if (rc)
+		{
+			dbg->fatal("void karte_t::init_threads()", "Failed to create path explorer worker thread, error %d. See here for a translation of the error numbers: http://epydoc.sourceforge.net/stdlib/errno-module.html", rc);
+		}
+		else
+		{
+			path_explorer_threads.append(thread);
+		}
+	}
+	path_explorer_t::set_explore_thread_count(parallel_operations + 1);
 #endif
 
 	threads_initialised = true;
@@ -2210,6 +2296,7 @@ void karte_t::destroy_threads()
 #endif
 #ifdef MULTI_THREAD_PATH_EXPLORER
 		await_path_explorer();
+		path_explorer_t::set_explore_thread_count(1);
 #endif
 #ifdef MULTI_THREAD_PASSENGER_GENERATION
 		await_passengers_and_mail_threads();
@@ -2230,6 +2317,9 @@ void karte_t::destroy_threads()
 #ifdef MULTI_THREAD_PATH_EXPLORER
 		simthread_barrier_wait(&path_explorer_barrier);
 		pthread_join(path_explorer_thread, 0);
+		simthread_barrier_wait(&path_explorer_workers_barrier);
+		clean_threads(&path_explorer_threads);
+		path_explorer_threads.clear();
 #endif
 #ifdef MULTI_THREAD_CONVOYS
 		pthread_join(convoy_step_master_thread, 0);
@@ -2257,6 +2347,7 @@ void karte_t::destroy_threads()
 
 #ifdef MULTI_THREAD_PATH_EXPLORER
 		simthread_barrier_destroy(&path_explorer_barrier);
+		simthread_barrier_destroy(&path_explorer_workers_barrier);
 #endif
 
 		// Destroy mutexes
@@ -2265,6 +2356,7 @@ void karte_t::destroy_threads()
 		pthread_mutex_destroy(&step_passengers_and_mail_mutex);
 		pthread_mutex_destroy(&path_explorer_await_mutex);
 		pthread_mutex_destroy(&unreserve_route_mutex);
+		pthread_mutex_destroy(&convoys_next_step_mutex);
 
 		pthread_mutexattr_destroy(&mutex_attributes);
 	}
@@ -4217,6 +4309,151 @@ void karte_t::sync_list_t::sync_step(uint32 delta_t)
 }
 
 
+// pedestrians are stepped in parallel in square regions of this size (in tiles)
+#define SYNC_REGION_SHIFT (6)
+#define SYNC_REGION_SIZE (1 << SYNC_REGION_SHIFT)
+
+// below this, the threads would cost more than they gain
+#define MIN_PARALLEL_PEDESTRIANS (1024)
+
+void karte_t::sync_step_pedestrians(uint32 delta_t)
+{
+	vector_tpl<sync_steppable *> &list = sync_pedestrians.list;
+	const uint32 count = list.get_count();
+	if(  count == 0  ) {
+		return;
+	}
+
+	const uint32 regions_x = (get_size().x + SYNC_REGION_SIZE - 1) >> SYNC_REGION_SHIFT;
+	const uint32 regions_y = (get_size().y + SYNC_REGION_SIZE - 1) >> SYNC_REGION_SHIFT;
+	const uint32 regions = regions_x * regions_y;
+
+	// A pedestrian cannot hop more often than it moves steps and looks only one tile
+	// beyond its last hop. If all tiles within this reach are in its own region, it
+	// cannot interfere with any pedestrian of another region.
+	sync_region_of.set_count( count );
+	sync_region_start.set_count( regions + 1 );
+	for(  uint32 r = 0;  r <= regions;  r++  ) {
+		sync_region_start[r] = 0;
+	}
+	uint32 parallel_count = 0;
+	for(  uint32 i = 0;  i < count;  i++  ) {
+		const pedestrian_t *ped = static_cast<const pedestrian_t *>(list[i]);
+		const koord pos = ped->get_pos().get_2d();
+		const uint32 reach = ped->get_max_hops( delta_t ) + 1;
+		const sint16 x_in = pos.x & (SYNC_REGION_SIZE - 1);
+		const sint16 y_in = pos.y & (SYNC_REGION_SIZE - 1);
+		if(  reach < SYNC_REGION_SIZE / 2  &&  x_in >= (sint16)reach  &&  x_in < SYNC_REGION_SIZE - (sint16)reach  &&  y_in >= (sint16)reach  &&  y_in < SYNC_REGION_SIZE - (sint16)reach  ) {
+			const uint32 r = (pos.y >> SYNC_REGION_SHIFT) * regions_x + (pos.x >> SYNC_REGION_SHIFT);
+			sync_region_of[i] = r;
+			sync_region_start[r]++;
+			parallel_count++;
+		}
+		else {
+			sync_region_of[i] = UINT32_MAX_VALUE;
+		}
+	}
+
+	// sort them into their regions
+	uint32 sum = 0;
+	for(  uint32 r = 0;  r < regions;  r++  ) {
+		const uint32 n = sync_region_start[r];
+		sync_region_start[r] = sum;
+		sum += n;
+	}
+	sync_region_members.set_count( parallel_count );
+	sync_region_results.set_count( count );
+	for(  uint32 i = 0;  i < count;  i++  ) {
+		if(  sync_region_of[i] != UINT32_MAX_VALUE  ) {
+			sync_region_members[ sync_region_start[ sync_region_of[i] ]++ ] = i;
+		}
+	}
+	// now every start is the end of its region
+	for(  uint32 r = regions;  r > 0;  r--  ) {
+		sync_region_start[r] = sync_region_start[r-1];
+	}
+	sync_region_start[0] = 0;
+
+	sync_pedestrians.sync_step_running = true;
+	sync_pedestrians.currently_deleting = NULL;
+
+	sync_region_delta_t = delta_t;
+#ifdef MULTI_THREAD
+	if(  parallel_count >= MIN_PARALLEL_PEDESTRIANS  &&  env_t::num_threads > 1  ) {
+		// The screen dirty marks are shared by all regions, so do the marking of
+		// do_drive() here, before the threads move the pedestrians.
+		for(  uint32 m = 0;  m < parallel_count;  m++  ) {
+			static_cast<pedestrian_t *>(list[ sync_region_members[m] ])->mark_image_dirty_before_move( delta_t );
+		}
+		world_xy_loop( &karte_t::sync_step_pedestrians_loop, 0 );
+	}
+	else
+#endif
+	{
+		sync_step_pedestrians_loop( 0, get_size().x, 0, get_size().y );
+	}
+
+	// delete the pedestrians which ended in the parallel part, in a fixed order
+	for(  uint32 m = 0;  m < parallel_count;  m++  ) {
+		const uint32 i = sync_region_members[m];
+		if(  sync_region_results[i] != SYNC_OK  ) {
+			if(  sync_region_results[i] == SYNC_DELETE  ) {
+				sync_pedestrians.currently_deleting = list[i];
+				delete list[i];
+				sync_pedestrians.currently_deleting = NULL;
+			}
+			list[i] = NULL;
+		}
+	}
+
+	// and the ones near the region borders one after another
+	for(  uint32 i = 0;  i < count;  i++  ) {
+		if(  sync_region_of[i] == UINT32_MAX_VALUE  ) {
+			sync_steppable *ss = list[i];
+			switch(  ss->sync_step( delta_t )  ) {
+				case SYNC_OK:
+					break;
+				case SYNC_DELETE:
+					sync_pedestrians.currently_deleting = ss;
+					delete ss;
+					sync_pedestrians.currently_deleting = NULL;
+					/* fall-through */
+				case SYNC_REMOVE:
+					list[i] = NULL;
+			}
+		}
+	}
+
+	// close the gaps, keeping the order
+	uint32 j = 0;
+	for(  uint32 i = 0;  i < list.get_count();  i++  ) {
+		if(  list[i] != NULL  ) {
+			list[j++] = list[i];
+		}
+	}
+	list.set_count( j );
+
+	sync_pedestrians.sync_step_running = false;
+}
+
+
+void karte_t::sync_step_pedestrians_loop(sint16, sint16, sint16 y_min, sint16 y_max)
+{
+	const vector_tpl<sync_steppable *> &list = sync_pedestrians.list;
+	const uint32 regions_x = (get_size().x + SYNC_REGION_SIZE - 1) >> SYNC_REGION_SHIFT;
+
+	// each call takes the regions starting in its rows
+	const uint32 r_min = ((y_min + SYNC_REGION_SIZE - 1) >> SYNC_REGION_SHIFT) * regions_x;
+	const uint32 r_max = ((y_max + SYNC_REGION_SIZE - 1) >> SYNC_REGION_SHIFT) * regions_x;
+	for(  uint32 r = r_min;  r < r_max;  r++  ) {
+		for(  uint32 m = sync_region_start[r];  m < sync_region_start[r+1];  m++  ) {
+			const uint32 i = sync_region_members[m];
+			sync_region_results[i] = (uint8)list[i]->sync_step( sync_region_delta_t );
+		}
+	}
+}
+
+
 /*
  * this routine is called before an image is displayed
  * it moves vehicles and pedestrians
@@ -4273,6 +4510,8 @@ void karte_t::sync_step(uint32 delta_t, bool do_sync_step, bool display )
 
 		sync.sync_step( delta_t );
 
+		sync_step_pedestrians( delta_t );
+
 		rands[4] = get_random_seed();
 
 		ticker::update();
@@ -4709,7 +4948,7 @@ void karte_t::new_month()
 	if( !env_t::networkmode && env_t::autosave>0 && last_month%env_t::autosave==0 && !win_get_magic(magic_welt_gui_t) ) {
 		char buf[128];
 		sprintf( buf, "save/autosave%02i.sve", last_month+1 );
-		save( buf, true, env_t::savegame_version_str, env_t::savegame_ex_version_str, env_t::savegame_ex_revision_str, true );
+		autosave( buf );
 	}
 
 	recalc_passenger_destination_weights();
@@ -4967,6 +5206,9 @@ void karte_t::pause_step()
 
 void karte_t::step()
 {
+	// times of the phases below for the step profile; the step ends with the scope
+	step_timer_t step_timer(step_profiler_t::OTHER, true);
+
 	rands[8] = get_random_seed();
 	DBG_DEBUG4("karte_t::step", "start step");
 	uint32 time = dr_time();
@@ -4989,7 +5231,9 @@ void karte_t::step()
 		next_month_ticks += karte_t::ticks_per_world_month;
 
 		DBG_DEBUG4("karte_t::step", "calling new_month");
+		step_timer.next(step_profiler_t::NEW_MONTH);
 		new_month();
+		step_timer.next(step_profiler_t::OTHER);
 	}
 	rands[9] = get_random_seed();
 
@@ -5055,6 +5299,7 @@ void karte_t::step()
 	//const uint32 check_frequency = max(cities.get_count() / 6, 1);
 	//const bool check_city_routes = (steps % check_frequency) == 0;
 	const bool check_city_routes = true;
+	step_timer.next(step_profiler_t::PRIVATE_CAR_ROUTES);
 	if (check_city_routes)
 	{
 		const sint32 parallel_operations = get_parallel_operations();
@@ -5094,6 +5339,7 @@ void karte_t::step()
 	rands[10] = get_random_seed();
 
 	// check for pending seasons change
+	step_timer.next(step_profiler_t::SEASONS);
 	// This is not very computationally intensive.
 	const bool season_change = pending_season_change > 0;
 	const bool snowline_change = pending_snowline_change > 0;
@@ -5125,6 +5371,7 @@ void karte_t::step()
 	// to make sure the tick counter will be updated
 	INT_CHECK("karte_t::step 1");
 
+	step_timer.next(step_profiler_t::PATH_EXPLORER);
 #ifdef MULTI_THREAD_PATH_EXPLORER
 	// Stop the path explorer before we use its results.
 	await_path_explorer();
@@ -5136,6 +5383,7 @@ void karte_t::step()
 
 	INT_CHECK("karte_t::step 2");
 
+	step_timer.next(step_profiler_t::CONVOY_ROUTES);
 #ifdef MULTI_THREAD_CONVOYS
 	// Finish the threaded part of the convoys' steps: this is mainly route searches. Block reservation, etc., is in the single threaded part.
 	await_convoy_threads();
@@ -5150,6 +5398,7 @@ void karte_t::step()
 	rands[13] = get_random_seed();
 
 	// The more computationally intensive parts of this have been extracted and made multi-threaded.
+	step_timer.next(step_profiler_t::CONVOYS);
 	DBG_DEBUG4("karte_t::step 4", "step %d convois", convoi_array.get_count());
 	// since convois will be deleted during stepping, we need to step backwards
 	for (uint32 i = convoi_array.get_count(); i-- != 0;) {
@@ -5171,6 +5420,7 @@ void karte_t::step()
 	// Processing private car routes is, however, quite computationally intensive, so only do one town per step.
 	// This probably cannot usefully be multi-threaded as all instances would need to access the same road data.
 	DBG_DEBUG4("karte_t::step 6", "step cities");
+	step_timer.next(step_profiler_t::CITIES);
 
 #define CONCURRENT_ROUTE_PROCESSING
 #ifndef CONCURRENT_ROUTE_PROCESSING
@@ -5185,6 +5435,7 @@ void karte_t::step()
 
 	INT_CHECK("karte_t::step 3b");
 
+	step_timer.next(step_profiler_t::PRIVATE_CARS);
 #ifdef MULTI_THREAD
 	// The placement of this method call must be before any code that in any way relies on the private car routes between cities, most especially the mail and passenger generation (step_passengers_and_mail(delta_t)).
 	if (check_city_routes)
@@ -5200,6 +5451,7 @@ void karte_t::step()
 
 	INT_CHECK("karte_t::step 3c");
 
+	step_timer.next(step_profiler_t::PASSENGERS_AND_MAIL);
 	rands[24] = 0;
 	rands[25] = 0;
 	rands[26] = 0;
@@ -5334,7 +5586,7 @@ void karte_t::step()
 			}
 			if (ok)
 			{
-				sync.add(ped);
+				sync_pedestrians.add(ped);
 
 				if (i > 0)
 				{
@@ -5357,10 +5609,12 @@ void karte_t::step()
 	INT_CHECK("karte_t::step 5");
 
 	DBG_DEBUG4("karte_t::step", "step factories");
+	step_timer.next(step_profiler_t::FACTORIES);
 	FOR(vector_tpl<fabrik_t*>, const f, fab_list) {
 		f->step(delta_t);
 	}
 	rands[20] = get_random_seed();
+	step_timer.next(step_profiler_t::PLAYERS_AND_HALTS);
 
 	finance_history_year[0][WORLD_FACTORIES] = finance_history_month[0][WORLD_FACTORIES] = fab_list.get_count();
 
@@ -5410,6 +5664,7 @@ void karte_t::step()
 	check_transferring_cargoes();
 
 	rands[25] = get_random_seed();
+	step_timer.next(step_profiler_t::OTHER);
 
 #ifdef MULTI_THREAD_PATH_EXPLORER
 	// Start the path explorer ready for the next step. This can be very
@@ -5438,7 +5693,9 @@ void karte_t::step()
 	recalc_season_snowline(true);
 
 	// This is not particularly computationally intensive.
+	step_timer.next(step_profiler_t::SIGNALS);
 	step_time_interval_signals();
+	step_timer.next(step_profiler_t::OTHER);
 
 	/** END OF THREADABLE AREA **/
 
@@ -5492,9 +5749,7 @@ void karte_t::refresh_private_car_routes() {
 void karte_t::clear_private_car_routes() {
 	weg_t::private_car_route_map::route_map_lock();
 	for(auto & w : weg_t::get_alle_wege()) {
-		for(auto & l : w->private_car_routes[weg_t::get_private_car_routes_currently_writing_element()]) {
-			l.pre_reset();
-		}
+		w->clear_private_car_routes(weg_t::get_private_car_routes_currently_writing_element());
 	}
 	weg_t::private_car_route_map::reset(weg_t::get_private_car_routes_currently_writing_element());
 
@@ -7820,6 +8075,7 @@ bool karte_t::play_sound_area_clipped(koord const k, uint16 const idx, sound_typ
 void karte_t::save(const char *filename, bool autosave, const char *version_str, const char *ex_version_str, const char* ex_revision_str, bool silent )
 {
 DBG_MESSAGE("karte_t::save()", "saving game to '%s'", filename);
+	await_background_save();
 	loadsave_t  file;
 	std::string savename = filename;
 	if (!env_t::networkmode || env_t::server)
@@ -7870,6 +8126,88 @@ DBG_MESSAGE("karte_t::save()", "saving game to '%s'", filename);
 }
 
 
+#ifdef MULTI_THREAD
+static void *background_save_threaded(void *)
+{
+	// like karte_t::save(), write to a temporary file first
+	std::string savename = background_save_filename;
+	savename[savename.length() - 1] = '_';
+
+	// write_snapshot() only succeeds once the file has been completely written and closed,
+	// so a truncated file never replaces the previous autosave
+	const char *err = loadsave_t::write_snapshot(background_save_snapshot, savename.c_str(), background_save_mode, background_save_level);
+	if(  err  ) {
+		dbg->error("background_save_threaded()", "cannot save game to '%s': %s", savename.c_str(), err);
+		dr_remove(savename.c_str());
+	}
+	else {
+		const int renamed_correctly = dr_rename(savename.c_str(), background_save_filename.c_str());
+		if(  renamed_correctly  ) {
+			dbg->error("background_save_threaded()", "cannot open file for renaming: error %u. check permissions.", renamed_correctly);
+		}
+	}
+
+	background_save_snapshot.release();
+	return NULL;
+}
+#endif
+
+
+void karte_t::autosave(const char *filename)
+{
+#ifdef MULTI_THREAD
+	await_background_save();
+
+	// XML is written directly by loadsave_t, it cannot be made from a snapshot
+	if(  !(loadsave_t::autosave_mode & loadsave_t::xml)  &&  save(background_save_snapshot, env_t::savegame_version_str, env_t::savegame_ex_version_str)  ) {
+		// the main thread may change the working directory while the thread saves
+		background_save_filename = std::string(env_t::user_dir) + filename;
+		background_save_mode = loadsave_t::autosave_mode;
+		background_save_level = loadsave_t::autosave_level;
+		if(  pthread_create(&background_save_thread, NULL, &background_save_threaded, NULL) == 0  ) {
+			background_save_running = true;
+			return;
+		}
+		dbg->warning("karte_t::autosave()", "Failed to create background save thread, saving directly");
+	}
+	background_save_snapshot.release();
+#endif
+	save( filename, true, env_t::savegame_version_str, env_t::savegame_ex_version_str, env_t::savegame_ex_revision_str, true );
+}
+
+
+void karte_t::await_background_save()
+{
+#ifdef MULTI_THREAD
+	if(  background_save_running  ) {
+		pthread_join(background_save_thread, NULL);
+		background_save_running = false;
+	}
+#endif
+}
+
+
+bool karte_t::save(memory_rdwr_stream_t::buffer_t &snapshot, const char *version_str, const char *ex_version_str)
+{
+DBG_MESSAGE("karte_t::save()", "saving game to memory");
+	loadsave_t file;
+	display_show_load_pointer( true );
+
+	bool ok = file.wr_open( snapshot, env_t::objfilename.c_str(), version_str, ex_version_str ) == loadsave_t::FILE_STATUS_OK;
+	if(  ok  ) {
+		save(&file,true);
+		const char *err = file.close();
+		if(  err  ) {
+			dbg->error("karte_t::save()", "cannot save game to memory: %s", err);
+			ok = false;
+		}
+		reset_interaction();
+	}
+	display_show_load_pointer( false );
+	return ok;
+}
+
+
 void karte_t::save(loadsave_t *file, bool silent)
 {
 	bool needs_redraw = false;
@@ -8844,8 +9182,10 @@ void karte_t::switch_server( bool start_server, bool port_forwarding )
 
 // LOAD, not save
 // just the preliminaries, opens the file, checks the versions ...
-bool karte_t::load(const char *filename)
+bool karte_t::load(const char *filename, memory_rdwr_stream_t::buffer_t *snapshot)
 {
+	await_background_save();
+
 	dbg->message("karte_t::load", "suspending private car threads");
 #ifdef MULTI_THREAD
 	suspend_private_car_threads(); // Necessary here to prevent thread deadlocks.
@@ -8923,7 +9263,8 @@ bool karte_t::load(const char *filename)
 		name.append(filename);
 	}
 
-	if(file.rd_open(name) != loadsave_t::FILE_STATUS_OK) {
+	const loadsave_t::file_status_t status = snapshot ? file.rd_open(*snapshot) : file.rd_open(name);
+	if(status != loadsave_t::FILE_STATUS_OK) {
 
 		if(file.get_version_int() == 0 || file.get_version_int() > loadsave_t::int_version(env_t::savegame_version_str, NULL).version) {
 			dbg->warning("karte_t::load()", translator::translate("WRONGSAVE") );
@@ -9134,6 +9475,21 @@ void karte_t::plans_finish_rd( sint16 x_min, sint16 x_max, sint16 y_min, sint16
 #endif
 }
 
+void karte_t::halts_finish_rd_cargo( sint16 x_min, sint16 x_max, sint16 y_min, sint16 y_max )
+{
+	FOR(vector_tpl<halthandle_t>, const halt, haltestelle_t::get_alle_haltestellen()) {
+		if(  !halt->get_owner()  ||  !halt->existiert_in_welt()  ) {
+			continue;
+		}
+		const koord pos = halt->get_basis_pos();
+		// stops without a valid position are done with the first area
+		const bool in_area = is_within_limits(pos) ? (pos.x >= x_min  &&  pos.x < x_max  &&  pos.y >= y_min  &&  pos.y < y_max) : (x_min == 0  &&  y_min == 0);
+		if(  in_area  ) {
+			halt->finish_rd_cargo();
+		}
+	}
+}
+
 void karte_t::clear_checklist_history()
 {
 	// TODO: either explain or remove the use of pre-increment (++i)
@@ -9270,6 +9626,19 @@ DBG_MESSAGE("karte_t::load()", "%d factories loaded", fab_list.get_count());
 
 	ls.set_progress( (get_size().y*3)/2+256+get_size().y/3 );
 
+	// the goods waiting at each stop are independent of all other stops, so they are finished in parallel;
+	// but games of 111.5 or older look up stops while doing so
+	if(  file->is_version_atleast(111, 6)  ) {
+		world_xy_loop(&karte_t::halts_finish_rd_cargo, 0);
+	}
+	else {
+		FOR(vector_tpl<halthandle_t>, const i, haltestelle_t::get_alle_haltestellen()) {
+			if (i->get_owner() && i->existiert_in_welt()) {
+				i->finish_rd_cargo();
+			}
+		}
+	}
+
 	// resolve dummy stops into real stops first ...
 	FOR(vector_tpl<halthandle_t>, const i, haltestelle_t::get_alle_haltestellen()) {
 		if (i->get_owner() && i->existiert_in_welt()) {
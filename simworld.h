@@ -765,6 +765,11 @@ private:
 	 */
 	void plans_finish_rd(sint16, sint16, sint16, sint16);
 
+	/**
+	 * Finishes the waiting goods of the stops based in this area after load.
+	 */
+	void halts_finish_rd_cargo(sint16, sint16, sint16, sint16);
+
 	/**
 	 * Updates all images.
 	 */
@@ -865,6 +870,10 @@ public:
 	void start_passengers_and_mail_threads();
 	void start_convoy_threads();
 	void start_path_explorer();
+#ifdef MULTI_THREAD_PATH_EXPLORER
+	// Runs the exploration of one transfer on the path explorer worker threads and the calling thread
+	void step_path_explorer_workers();
+#endif
 	void start_private_car_threads(bool override_suspend = false);
 #else
 public:
@@ -910,6 +919,7 @@ private:
 	friend void *step_passengers_and_mail_threaded(void* args);
 	friend void *step_convoys_threaded(void* args);
 	friend void *path_explorer_threaded(void* args);
+	friend void *path_explorer_worker_threaded(void* args);
 	friend void *step_individual_convoy_threaded(void* args);
 	static vector_tpl<convoihandle_t> convoys_next_step;
 	public:
@@ -2183,6 +2193,7 @@ public:
 	sync_list_t sync;              ///< vehicles, transformers, traffic lights
 	sync_list_t sync_eyecandy;     ///< animated buildings
 	sync_list_t sync_way_eyecandy; ///< smoke
+	sync_list_t sync_pedestrians;  ///< pedestrians, see sync_step_pedestrians()
 
 	/**
 	 * Synchronous stepping of objects like vehicles.
@@ -2302,6 +2313,25 @@ public:
 	 */
 	void cleanup_grounds_loop(sint16, sint16, sint16, sint16);
 
+	/**
+	 * Steps the pedestrians. The map is split into square regions of fixed size.
+	 * Pedestrians which cannot leave their region during this step are stepped
+	 * region by region in parallel, the others afterwards in list order. Hence the
+	 * result does not depend on the number of threads.
+	 */
+	void sync_step_pedestrians(uint32 delta_t);
+
+	/**
+	 * Loop stepping the pedestrians of the regions starting in these rows - suitable for multithreading
+	 */
+	void sync_step_pedestrians_loop(sint16, sint16, sint16, sint16);
+
+	vector_tpl<uint32> sync_region_of;      ///< region of each pedestrian, or UINT32_MAX_VALUE if stepped afterwards
+	vector_tpl<uint32> sync_region_start;   ///< first entry of each region in sync_region_members
+	vector_tpl<uint32> sync_region_members; ///< pedestrians sorted by region, in list order
+	vector_tpl<uint8> sync_region_results;  ///< sync_result of the parallel step of each pedestrian
+	uint32 sync_region_delta_t;
+
 public:
 	/**
 	 * @return Minimum height of the planquadrats (tile) at i, j. - for speed no checks performed that coordinates are valid
@@ -2362,11 +2392,28 @@ public:
 	 */
 	void save(const char *filename, bool autosave, const char *version, const char *ex_version, const char* ex_revision, bool silent);
 
+	/**
+	 * Saves the map uncompressed into memory, to be reloaded by load() without going through a file.
+	 * @returns false if saving failed.
+	 */
+	bool save(memory_rdwr_stream_t::buffer_t &snapshot, const char *version, const char *ex_version);
+
+	/**
+	 * Autosaves the map to a file. The map is saved to memory first, then compressed
+	 * and written by a background thread while the game continues (if multithreaded).
+	 * @param filename relative to the user directory
+	 */
+	void autosave(const char *filename);
+
+	/// Waits until a background autosave has been written.
+	void await_background_save();
+
 	/**
 	 * Loads a map from a file.
 	 * @param filename name of the file to read.
+	 * @param snapshot if not NULL, the map is read from there instead, but otherwise treated as coming from @p filename.
 	 */
-	bool load(const char *filename);
+	bool load(const char *filename, memory_rdwr_stream_t::buffer_t *snapshot = NULL);
 
 	/**
 	 * Creates a map from a heightfield.
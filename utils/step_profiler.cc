@@ -0,0 +1,210 @@
+/*
+ * This file is part of the Simutrans-Extended project under the Artistic License.
+ * (see LICENSE.txt)
+ */
+
+#include <algorithm>
+#include <chrono>
+#include <string.h>
+
+#include "step_profiler.h"
+#include "cbuffer_t.h"
+#include "csv.h"
+#include "../macros.h"
+
+
+uint32 step_profiler_t::history[MAX_PHASES][HISTORY];
+uint32 step_profiler_t::current[MAX_PHASES];
+uint64 step_profiler_t::total[MAX_PHASES];
+uint32 step_profiler_t::steps = 0;
+std::atomic<uint32> step_profiler_t::earliest_arrival_queries(0);
+uint32 step_profiler_t::earliest_arrival_query_history[HISTORY];
+
+
+static uint64 get_microseconds()
+{
+	return (uint64)std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+
+const char *step_profiler_t::get_phase_name(phase_t phase)
+{
+	static const char *const names[MAX_PHASES] = {
+		"new_month",
+		"private_car_routes",
+		"seasons",
+		"path_explorer",
+		"convoy_routes",
+		"convoys",
+		"cities",
+		"private_cars",
+		"passengers_and_mail",
+		"factories",
+		"players_and_halts",
+		"signals",
+		"other"
+	};
+	return names[phase];
+}
+
+
+void step_profiler_t::end_step()
+{
+	const uint32 index = steps % HISTORY;
+	for(  int p=0;  p<MAX_PHASES;  p++  ) {
+		history[p][index] = current[p];
+		total[p] += current[p];
+		current[p] = 0;
+	}
+	// queries from threads still running count for the next step
+	earliest_arrival_query_history[index] = earliest_arrival_queries.exchange(0, std::memory_order_relaxed);
+	steps++;
+}
+
+
+void step_profiler_t::reset()
+{
+	MEMZERO(history);
+	MEMZERO(current);
+	MEMZERO(total);
+	MEMZERO(earliest_arrival_query_history);
+	earliest_arrival_queries = 0;
+	steps = 0;
+}
+
+
+uint32 step_profiler_t::get_bucket(uint32 microseconds)
+{
+	uint32 bucket = 0;
+	while(  microseconds > 0  &&  bucket < BUCKETS-1  ) {
+		microseconds >>= 1;
+		bucket++;
+	}
+	return bucket;
+}
+
+
+uint32 step_profiler_t::get_sorted(const uint32 *values, uint32 *sorted)
+{
+	const uint32 count = std::min<uint32>(steps, HISTORY);
+	for(  uint32 i=0;  i<count;  i++  ) {
+		sorted[i] = values[i];
+	}
+	std::sort(sorted, sorted+count);
+	return count;
+}
+
+
+void step_profiler_t::print(cbuffer_t &buf)
+{
+	uint32 sorted[HISTORY];
+	uint64 sum[MAX_PHASES];
+	uint64 sum_all = 0;
+	uint32 count = 0;
+	for(  int p=0;  p<MAX_PHASES;  p++  ) {
+		count = get_sorted_history((phase_t)p, sorted);
+		sum[p] = 0;
+		for(  uint32 i=0;  i<count;  i++  ) {
+			sum[p] += sorted[i];
+		}
+		sum_all += sum[p];
+	}
+
+	buf.printf("Step profile of the last %u steps (%u since reset), times in microseconds\n", count, steps);
+	if(  count == 0  ) {
+		return;
+	}
+	buf.printf("%-20s %9s %9s %9s %9s %6s\n", "phase", "avg", "median", "95%", "max", "share");
+	for(  int p=0;  p<MAX_PHASES;  p++  ) {
+		get_sorted_history((phase_t)p, sorted);
+		buf.printf("%-20s %9u %9u %9u %9u %5.1f%%\n",
+			get_phase_name((phase_t)p),
+			(uint32)(sum[p] / count), sorted[count/2], sorted[(count*95)/100], sorted[count-1],
+			sum_all ? (double)sum[p] * 100.0 / (double)sum_all : 0.0);
+	}
+	buf.printf("%-20s %9u\n", "total", (uint32)(sum_all / count));
+
+	// how often stops were asked for the earliest arrival at the next transfer
+	get_sorted(earliest_arrival_query_history, sorted);
+	uint64 queries = 0;
+	for(  uint32 i=0;  i<count;  i++  ) {
+		queries += sorted[i];
+	}
+	buf.printf("\nEarliest arrival queries per step\n");
+	buf.printf("%-20s %9u %9u %9u %9u\n", "queries", (uint32)(queries / count), sorted[count/2], sorted[(count*95)/100], sorted[count-1]);
+}
+
+
+void step_profiler_t::print_csv(cbuffer_t &buf)
+{
+	CSV_t csv;
+	csv.add_field("phase");
+	csv.add_field("steps");
+	csv.add_field("avg_us");
+	csv.add_field("median_us");
+	csv.add_field("p95_us");
+	csv.add_field("max_us");
+	csv.add_field("total_ms");
+	for(  uint32 b=0;  b<BUCKETS;  b++  ) {
+		cbuffer_t label;
+		if(  b < BUCKETS-1  ) {
+			label.printf("<%uus", 1u << b);
+		}
+		else {
+			label.printf(">=%uus", 1u << (b-1));
+		}
+		csv.add_field(label);
+	}
+	csv.new_line();
+
+	uint32 sorted[HISTORY];
+	for(  int p=0;  p<MAX_PHASES;  p++  ) {
+		const uint32 count = get_sorted_history((phase_t)p, sorted);
+		uint64 sum = 0;
+		uint32 buckets[BUCKETS];
+		MEMZERO(buckets);
+		for(  uint32 i=0;  i<count;  i++  ) {
+			sum += sorted[i];
+			buckets[get_bucket(sorted[i])]++;
+		}
+
+		csv.add_field(get_phase_name((phase_t)p));
+		csv.add_field(count);
+		csv.add_field(count ? (int)(sum / count) : 0);
+		csv.add_field(count ? (int)sorted[count/2] : 0);
+		csv.add_field(count ? (int)sorted[(count*95)/100] : 0);
+		csv.add_field(count ? (int)sorted[count-1] : 0);
+		csv.add_field((int)(total[p] / 1000));
+		for(  uint32 b=0;  b<BUCKETS;  b++  ) {
+			csv.add_field(buckets[b]);
+		}
+		csv.new_line();
+	}
+	buf.append(csv.get_str());
+}
+
+
+step_timer_t::step_timer_t(step_profiler_t::phase_t phase, bool ends_step) :
+	phase(phase),
+	start(get_microseconds()),
+	ends_step(ends_step)
+{
+}
+
+
+step_timer_t::~step_timer_t()
+{
+	step_profiler_t::add(phase, (uint32)(get_microseconds() - start));
+	if(  ends_step  ) {
+		step_profiler_t::end_step();
+	}
+}
+
+
+void step_timer_t::next(step_profiler_t::phase_t next_phase)
+{
+	const uint64 now = get_microseconds();
+	step_profiler_t::add(phase, (uint32)(now - start));
+	phase = next_phase;
+	start = now;
+}
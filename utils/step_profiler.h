@@ -0,0 +1,114 @@
+/*
+ * This file is part of the Simutrans-Extended project under the Artistic License.
+ * (see LICENSE.txt)
+ */
+
+#ifndef UTILS_STEP_PROFILER_H
+#define UTILS_STEP_PROFILER_H
+
+
+#include "../simtypes.h"
+
+#include <atomic>
+
+class cbuffer_t;
+
+/**
+ * Collects the wall clock time the main thread spends in each phase of
+ * karte_t::step(). For every phase the times of the last HISTORY steps are kept,
+ * from which the averages, percentiles and histograms of the reports are made.
+ * Only to be used from the main thread.
+ */
+class step_profiler_t
+{
+public:
+	enum phase_t {
+		NEW_MONTH = 0,
+		PRIVATE_CAR_ROUTES,  ///< starting the private car route checks
+		SEASONS,
+		PATH_EXPLORER,       ///< path explorer step, or waiting for its thread
+		CONVOY_ROUTES,       ///< threaded convoy step (route searches), or waiting for it
+		CONVOYS,             ///< single threaded convoy step
+		CITIES,
+		PRIVATE_CARS,        ///< waiting for the private car route checks, travel time updates
+		PASSENGERS_AND_MAIL,
+		FACTORIES,
+		PLAYERS_AND_HALTS,   ///< power nets, players, halts, rerouting, transferring cargo
+		SIGNALS,             ///< step_time_interval_signals()
+		OTHER,
+		MAX_PHASES
+	};
+
+	enum {
+		HISTORY = 256,       ///< number of steps the statistics are taken over
+		BUCKETS = 20         ///< histogram buckets: <1us, <2us, <4us ... and the rest
+	};
+
+private:
+	/// times of the last HISTORY steps per phase in microseconds
+	static uint32 history[MAX_PHASES][HISTORY];
+
+	/// time spent per phase in the current step
+	static uint32 current[MAX_PHASES];
+
+	/// time spent per phase since the last reset in microseconds
+	static uint64 total[MAX_PHASES];
+
+	/// steps completed since the last reset
+	static uint32 steps;
+
+	/// haltestelle_t::calc_earliest_arrival_time_at() calls in the current step and in the last HISTORY steps
+	static std::atomic<uint32> earliest_arrival_queries;
+	static uint32 earliest_arrival_query_history[HISTORY];
+
+	static uint32 get_bucket(uint32 microseconds);
+
+	/// sorted copy of the last HISTORY values, returns the number of entries
+	static uint32 get_sorted(const uint32 *values, uint32 *sorted);
+
+	/// sorted copy of the history of a phase, returns the number of entries
+	static uint32 get_sorted_history(phase_t phase, uint32 *sorted) { return get_sorted(history[phase], sorted); }
+
+public:
+	static const char *get_phase_name(phase_t phase);
+
+	/// add time to a phase of the current step
+	static void add(phase_t phase, uint32 microseconds) { current[phase] += microseconds; }
+
+	/// count a call of haltestelle_t::calc_earliest_arrival_time_at(); may be called from any thread
+	static void count_earliest_arrival_query() { earliest_arrival_queries.fetch_add(1, std::memory_order_relaxed); }
+
+	/// store the times of the current step in the history
+	static void end_step();
+
+	/// forget all statistics
+	static void reset();
+
+	/// human readable table of all phases
+	static void print(cbuffer_t &buf);
+
+	/// CSV with one line per phase, including the histogram buckets
+	static void print_csv(cbuffer_t &buf);
+};
+
+
+/**
+ * Measures the time until the next phase is started or the timer goes out of
+ * scope, and adds it to the running phase.
+ */
+class step_timer_t
+{
+	step_profiler_t::phase_t phase;
+	uint64 start;
+	bool ends_step;
+
+public:
+	/// @param ends_step if true, the step is complete when this timer goes out of scope
+	explicit step_timer_t(step_profiler_t::phase_t phase, bool ends_step = false);
+	~step_timer_t();
+
+	/// stop timing the current phase and start timing the given one
+	void next(step_profiler_t::phase_t next_phase);
+};
+
+#endif
@@ -80,7 +80,7 @@ pedestrian_t::pedestrian_t(loadsave_t *file)
 	steps_offset = 0;
 	rdwr(file);
 	if(desc) {
-		welt->sync.add(this);
+		welt->sync_pedestrians.add(this);
 		ped_offset = desc->get_offset();
 	}
 	calc_disp_lane();
@@ -108,7 +108,7 @@ pedestrian_t::pedestrian_t(grund_t *gr, uint32 time_to_live) :
 pedestrian_t::~pedestrian_t()
 {
 	if(  time_to_life>0  ) {
-		welt->sync.remove( this );
+		welt->sync_pedestrians.remove( this );
 	}
 }
 
@@ -246,7 +246,7 @@ void pedestrian_t::generate_pedestrians_at(const koord3d k, uint32 count, uint32
 #ifdef MULTI_THREAD
 				karte_t::pedestrians_added_threaded[karte_t::passenger_generation_thread_number].append(ped);
 #else
-				welt->sync.add(ped);
+				welt->sync_pedestrians.add(ped);
 			}
 			else
 			{
@@ -268,7 +268,7 @@ sync_result pedestrian_t::sync_step(uint32 delta_t)
 	time_to_life -= delta_t;
 
 	if (time_to_life>0) {
-		weg_next += 128*delta_t;
+		weg_next += PEDESTRIAN_SPEED*delta_t;
 		weg_next -= do_drive( weg_next );
 		return time_to_life>0 ? SYNC_OK : SYNC_DELETE;
 	}
@@ -276,6 +276,15 @@ sync_result pedestrian_t::sync_step(uint32 delta_t)
 }
 
 
+void pedestrian_t::mark_image_dirty_before_move(uint32 delta_t)
+{
+	if(  time_to_life > (sint32)delta_t  &&  get_max_hops( delta_t ) > 0  &&  !get_flag( obj_t::dirty )  ) {
+		mark_image_dirty( get_image(), 0 );
+		set_flag( obj_t::dirty );
+	}
+}
+
+
 grund_t* pedestrian_t::hop_check()
 {
 	grund_t *from = welt->lookup(pos_next);
@@ -324,8 +333,9 @@ void pedestrian_t::hop(grund_t *gr)
 	ribi_t::ribi reverse_direction = ribi_t::reverse_single( current_direction );
 	// all possible directions
 	ribi_t::ribi ribi = weg->get_ribi_unmasked() & (~reverse_direction);
-	// randomized offset
-	const uint8 offset = (ribi > 0 && ribi_t::is_single(ribi)) ? 0 : simrand(4, "void pedestrian_t::hop(grund_t *gr)");
+	// randomized offset; not from simrand(), since pedestrians are stepped on several threads
+	const uint32 hash = ((((uint32)get_pos().x << 16) ^ (uint32)get_pos().y) ^ (uint32)time_to_life) * 2654435761u;
+	const uint8 offset = (ribi > 0 && ribi_t::is_single(ribi)) ? 0 : (uint8)(hash >> 30);
 
 	ribi_t::ribi new_direction = ribi_t::none;
 	for(uint r = 0; r < 4; r++) {
@@ -12,6 +12,9 @@
 
 class pedestrian_desc_t;
 
+/// yards a pedestrian walks per tick
+#define PEDESTRIAN_SPEED (128)
+
 
 /**
  * Pedestrians also are road users.
@@ -61,6 +64,16 @@ public:
 
 	sync_result sync_step(uint32 delta_t) OVERRIDE;
 
+	/// upper limit of tiles this pedestrian may move during sync_step(delta_t)
+	uint32 get_max_hops(uint32 delta_t) const { return (weg_next + PEDESTRIAN_SPEED*delta_t) >> YARDS_PER_VEHICLE_STEP_SHIFT; }
+
+	/**
+	 * Marks the image dirty, if sync_step(delta_t) will move this pedestrian,
+	 * just like do_drive() would do. Then do_drive() finds the flag already set
+	 * and does not touch the screen, when called from several threads.
+	 */
+	void mark_image_dirty_before_move(uint32 delta_t);
+
 	///@ returns true if pedestrian walks on the left side of the road
 	bool is_on_left() const { return on_left; }
 